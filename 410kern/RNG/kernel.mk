@@ -1,4 +1,4 @@
-410KLIB_RNG_OBJS = $(410KDIR)/RNG/mt19937int.o
+410KLIB_RNG_OBJS = $(410KDIR)/RNG/mt19937int.o $(410KDIR)/RNG/pcg32.o
 
 ALL_410KOBJS += $(410KLIB_RNG_OBJS)
 410KCLEANS += $(410KDIR)/libRNG.a
@@ -28,6 +28,9 @@
 
 /* modified for 15-410 at CMU by Zachary Anderson(zra) */
 
+#include <stdint.h>
+#include "mt19937int.h"
+
 /* Period parameters */  
 #define N 624
 #define M 397
@@ -60,38 +63,71 @@ unsigned long seed;
         mt[mti] = (69069 * mt[mti-1]) & 0xffffffff;
 }
 
-unsigned long 
-genrand()
+/* generate N words at one time */
+static void
+regenerate(void)
 {
     unsigned long y;
     static unsigned long mag01[2]={0x0, MATRIX_A};
     /* mag01[x] = x * MATRIX_A  for x=0,1 */
+    int kk;
 
-    if (mti >= N) { /* generate N words at one time */
-        int kk;
+    if (mti == N+1)   /* if sgenrand() has not been called, */
+        sgenrand(4357); /* a default initial seed is used   */
 
-        if (mti == N+1)   /* if sgenrand() has not been called, */
-            sgenrand(4357); /* a default initial seed is used   */
+    for (kk=0;kk<N-M;kk++) {
+        y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);
+        mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & 0x1];
+    }
+    for (;kk<N-1;kk++) {
+        y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);
+        mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & 0x1];
+    }
+    y = (mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK);
+    mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & 0x1];
 
-        for (kk=0;kk<N-M;kk++) {
-            y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);
-            mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & 0x1];
-        }
-        for (;kk<N-1;kk++) {
-            y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);
-            mt[kk] = mt[kk+(M-N)] ^ (y >> 1) ^ mag01[y & 0x1];
-        }
-        y = (mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK);
-        mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & 0x1];
+    mti = 0;
+}
 
-        mti = 0;
-    }
-  
-    y = mt[mti++];
+static inline unsigned long
+temper(unsigned long y)
+{
     y ^= TEMPERING_SHIFT_U(y);
     y ^= TEMPERING_SHIFT_S(y) & TEMPERING_MASK_B;
     y ^= TEMPERING_SHIFT_T(y) & TEMPERING_MASK_C;
     y ^= TEMPERING_SHIFT_L(y);
+    return y;
+}
+
+unsigned long 
+genrand()
+{
+    if (mti >= N)
+        regenerate();
+  
+    return temper(mt[mti++]);
+}
 
-    return y; 
+/* fill out[0..n) with the same sequence n genrand() calls would return, */
+/* tempering straight out of the state vector a block at a time         */
+void
+genrand_fill(uint32_t *out, unsigned int n)
+{
+    while (n > 0) {
+        unsigned int chunk;
+        const unsigned long *p;
+
+        if (mti >= N)
+            regenerate();
+
+        chunk = N - mti;
+        if (chunk > n)
+            chunk = n;
+        n -= chunk;
+
+        p = &mt[mti];
+        mti += chunk;
+        while (chunk-- > 0)
+            *out++ = temper(*p++);
+    }
 }
@@ -29,7 +29,10 @@
 #ifndef _RAND_H
 #define _RAND_H
 
+#include <stdint.h>
+
 void sgenrand( unsigned long );
 unsigned long genrand();
+void genrand_fill( uint32_t *out, unsigned int n );
 
 #endif /* _RAND_H */
@@ -0,0 +1,32 @@
+/** @file pcg32.c
+ *  @brief Seeding and bulk generation for the PCG32 generator.
+ */
+
+#include <stdint.h>
+#include "pcg32.h"
+
+/** @brief Initializes a generator
+ *
+ *  Generators seeded with the same seed but different streams produce
+ *  unrelated sequences.
+ */
+void
+pcg32_seed(pcg32_t *rng, uint64_t seed, uint64_t stream)
+{
+  rng->state = 0;
+  rng->inc = (stream << 1) | 1;
+  (void)pcg32_next(rng);
+  rng->state += seed;
+  (void)pcg32_next(rng);
+}
+
+/** @brief Fills out[0..n) with the next n values of the generator */
+void
+pcg32_fill(pcg32_t *rng, uint32_t *out, unsigned int n)
+{
+  pcg32_t local = *rng;   /* keep the state in registers across the loop */
+
+  while (n-- > 0)
+    *out++ = pcg32_next(&local);
+  *rng = local;
+}
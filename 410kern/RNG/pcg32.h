@@ -0,0 +1,68 @@
+/** @file pcg32.h
+ *  @brief Small-state PCG32 generator with unbiased bounded sampling.
+ *
+ *  Each generator is 16 bytes of caller-owned state, so a game can keep
+ *  one per subsystem (level layout, shuffles, AI) and replay any of them
+ *  from its seed.  The output function is PCG-XSH-RR from O'Neill, "PCG: A
+ *  Family of Simple Fast Space-Efficient Statistically Good Algorithms for
+ *  Random Number Generation" (2014).
+ *
+ *  pcg32_bounded() replaces "rand() % n": it is exactly uniform over
+ *  [0, bound) and uses Lemire's multiply-and-shift method, so the common
+ *  case costs one multiply and no division.
+ */
+
+#ifndef _PCG32_H
+#define _PCG32_H
+
+#include <stdint.h>
+
+typedef struct pcg32 {
+  uint64_t state;   /* LCG state; every value is possible */
+  uint64_t inc;     /* stream selector; always odd */
+} pcg32_t;
+
+#define PCG32_MULT 6364136223846793005ULL
+
+void pcg32_seed(pcg32_t *rng, uint64_t seed, uint64_t stream);
+void pcg32_fill(pcg32_t *rng, uint32_t *out, unsigned int n);
+
+/** @brief Returns the next uniformly distributed 32-bit value */
+static inline uint32_t
+pcg32_next(pcg32_t *rng)
+{
+  uint64_t old = rng->state;
+  uint32_t xorshifted, rot;
+
+  rng->state = old * PCG32_MULT + rng->inc;
+  xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+  rot = (uint32_t)(old >> 59);
+  return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+/** @brief Returns a uniformly distributed value in [0, bound)
+ *
+ *  The high word of next() * bound is uniform except for the few low words
+ *  below (2^32 mod bound); those are rejected and redrawn.  The modulo that
+ *  computes the threshold only runs when a low word falls under bound,
+ *  which is rare unless bound is close to 2^32.
+ *
+ *  @pre bound is nonzero
+ */
+static inline uint32_t
+pcg32_bounded(pcg32_t *rng, uint32_t bound)
+{
+  uint64_t m = (uint64_t)pcg32_next(rng) * bound;
+  uint32_t low = (uint32_t)m;
+
+  if (low < bound) {
+    uint32_t threshold = (uint32_t)(-bound) % bound;
+    while (low < threshold) {
+      m = (uint64_t)pcg32_next(rng) * bound;
+      low = (uint32_t)m;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
+
+#endif /* _PCG32_H */
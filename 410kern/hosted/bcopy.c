@@ -0,0 +1,74 @@
+/** @file bcopy.c
+ *  @brief x86-64 renditions of 410kern/x86/bcopy.S and bzero.S.
+ *
+ *  The kernel's memcpy(), memmove(), bcopy() and bzero() are i386
+ *  assembly.  These use the same string instructions in the same way
+ *  (word moves plus a byte tail going forward, byte moves backward for an
+ *  overlapping copy, word stores after aligning for bzero) so that hosted
+ *  measurements track the kernel versions rather than the host's libc.
+ */
+
+#include <types.h>
+#include <stdint.h>
+#include <string.h>
+
+static void *
+copy(void *to, const void *from, size_t n)
+{
+	unsigned char *d = to;
+	const unsigned char *s = from;
+	size_t cnt;
+
+	if (d > s && d < s + n) {
+		/* overlapping, destination above source: copy backward */
+		d += n - 1;
+		s += n - 1;
+		cnt = n;
+		__asm__ volatile("std; rep movsb; cld"
+		                 : "+D" (d), "+S" (s), "+c" (cnt) : : "memory");
+		return to;
+	}
+
+	cnt = n >> 2;
+	__asm__ volatile("cld; rep movsl"
+	                 : "+D" (d), "+S" (s), "+c" (cnt) : : "memory");
+	cnt = n & 3;
+	__asm__ volatile("rep movsb"
+	                 : "+D" (d), "+S" (s), "+c" (cnt) : : "memory");
+	return to;
+}
+
+void *memcpy(void *to, const void *from, unsigned int n)
+{
+	return copy(to, from, n);
+}
+
+void *memmove(void *to, const void *from, unsigned int n)
+{
+	return copy(to, from, n);
+}
+
+void bcopy(const void *from, void *to, unsigned int n)
+{
+	copy(to, from, n);
+}
+
+void bzero(void *to, unsigned int n)
+{
+	unsigned char *d = to;
+	size_t cnt;
+
+	if (n >= 16) {
+		cnt = -(uintptr_t)d & 3;
+		n -= cnt;
+		__asm__ volatile("cld; rep stosb"
+		                 : "+D" (d), "+c" (cnt) : "a" (0) : "memory");
+		cnt = n >> 2;
+		n &= 3;
+		__asm__ volatile("rep stosl"
+		                 : "+D" (d), "+c" (cnt) : "a" (0) : "memory");
+	}
+	cnt = n;
+	__asm__ volatile("cld; rep stosb"
+	                 : "+D" (d), "+c" (cnt) : "a" (0) : "memory");
+}
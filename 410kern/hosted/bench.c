@@ -0,0 +1,122 @@
+/** @file bench.c
+ *  @brief Driver for the hosted benchmarks.
+ *
+ *  usage: bench [-q] [name-prefix ...]
+ *
+ *  -q shortens the time budget per measurement, for smoke runs.  With
+ *  prefixes, only benchmarks whose names start with one of them are run.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "hosted.h"
+#include "bench.h"
+
+/* Time budget for each (benchmark, size) measurement */
+#define BENCH_BUDGET_NS       (50 * 1000 * 1000ULL)
+#define BENCH_QUICK_BUDGET_NS (1 * 1000 * 1000ULL)
+
+volatile unsigned long bench_sink;
+
+static const bench_t *suites[] = {
+  bench_libc,
+  bench_sudoku,
+  bench_nonogram,
+  bench_sokoban,
+  bench_texttwist,
+  bench_console,
+  bench_serial,
+};
+
+static int quick;
+
+void bench_fail(const char *name, const char *what)
+{
+  printf("%s: FAILED: %s\n", name, what);
+  hosted_exit(1);
+}
+
+static int selected(const char *name, int nfilters, char **filters)
+{
+  int i;
+
+  if (nfilters == 0)
+    return 1;
+  for (i = 0; i < nfilters; i++)
+    if (!strncmp(name, filters[i], strlen(filters[i])))
+      return 1;
+  return 0;
+}
+
+/* Returns the total time spent in run() over iters calls */
+static uint64_t time_calls(const bench_t *b, int size, uint64_t iters)
+{
+  uint64_t i, start, total = 0;
+
+  if (!b->per_call_setup) {
+    start = hosted_now_ns();
+    for (i = 0; i < iters; i++)
+      b->run(size);
+    return hosted_now_ns() - start;
+  }
+
+  for (i = 0; i < iters; i++) {
+    b->setup(size);
+    start = hosted_now_ns();
+    b->run(size);
+    total += hosted_now_ns() - start;
+  }
+  return total;
+}
+
+static void measure(const bench_t *b, int size)
+{
+  uint64_t budget = quick ? BENCH_QUICK_BUDGET_NS : BENCH_BUDGET_NS;
+  uint64_t iters = 1, elapsed;
+
+  if (b->setup)
+    b->setup(size);
+
+  /* Double the iteration count until one round fills a tenth of the budget,
+   * then do a full-budget round for the reported number */
+  for (;;) {
+    elapsed = time_calls(b, size, iters);
+    if (elapsed >= budget / 10)
+      break;
+    iters *= 2;
+  }
+  iters = iters * budget / (elapsed ? elapsed : 1);
+  if (iters == 0)
+    iters = 1;
+  elapsed = time_calls(b, size, iters);
+
+  printf("%-24s %8d %14.1f ns/call\n", b->name, size,
+         (double)elapsed / (double)iters);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int s;
+  const bench_t *b;
+  const int *size;
+
+  argc--;
+  argv++;
+  if (argc > 0 && !strcmp(argv[0], "-q")) {
+    quick = 1;
+    argc--;
+    argv++;
+  }
+
+  printf("%-24s %8s %22s\n", "benchmark", "size", "time");
+  for (s = 0; s < sizeof(suites) / sizeof(suites[0]); s++) {
+    for (b = suites[s]; b->name; b++) {
+      if (!selected(b->name, argc, argv))
+        continue;
+      for (size = b->sizes; *size; size++)
+        measure(b, *size);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,41 @@
+/** @file bench.h
+ *  @brief Table-driven micro-benchmark harness for the hosted build.
+ *
+ *  A suite is an array of bench_t terminated by an entry with a NULL name.
+ *  For every size in a benchmark's list the harness calls setup() once,
+ *  then times run() over enough iterations to fill its time budget and
+ *  reports nanoseconds per call.
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+typedef struct bench {
+  /** Printed in the first column */
+  const char *name;
+  /** Sizes to run at, terminated by 0 */
+  const int *sizes;
+  /** Prepares the input for a size; untimed and may be NULL */
+  void (*setup)(int size);
+  /** The operation being measured */
+  void (*run)(int size);
+  /** Nonzero if run() consumes its input, so setup() must be repeated
+   *  (untimed) before every call */
+  int per_call_setup;
+} bench_t;
+
+/** Results are folded into this so the work can't be optimized away */
+extern volatile unsigned long bench_sink;
+
+/** @brief Reports a failed sanity check on a benchmark's output and exits */
+void bench_fail(const char *name, const char *what);
+
+extern const bench_t bench_libc[];
+extern const bench_t bench_sudoku[];
+extern const bench_t bench_nonogram[];
+extern const bench_t bench_sokoban[];
+extern const bench_t bench_texttwist[];
+extern const bench_t bench_console[];
+extern const bench_t bench_serial[];
+
+#endif /* _BENCH_H_ */
@@ -0,0 +1,672 @@
+/** @file bench_console.c
+ *  @brief Benchmarks for the console's bulk cell writers and escape
+ *         sequence parsing in kern/.
+ *
+ *  The screen is a RAM buffer laid out like text memory.  For the cell
+ *  writers the size is the number of 80-column rows drawn per call, so
+ *  cells per second is 80 * size / (time per call).  The driver's own
+ *  draw_char(), draw_span(), fill_rect(), blit_cells() and putbytes(), and
+ *  the frames, sprites, windows and recorder built on them, write to RAM
+ *  mapped where text memory would be.  For putbytes() and windows the size
+ *  is the bytes of output per call, and for a sprite its height.  For the
+ *  frame recorder's diffs it is the number of rows that changed between
+ *  the two frames.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <video_defines.h>
+#include <console_cells.h>
+#include <ansi.h>
+#include <framerec.h>
+#include <p1kern.h>
+#include <console_device_driver.h>
+#include <sprite.h>
+#include <window.h>
+#include <recorder.h>
+#include <malloc_internal.h>
+#include <lmm/lmm_types.h>
+#include "bench.h"
+#include "hosted.h"
+#include "devices.h"
+
+static const int row_sizes[] = { 1, CONSOLE_HEIGHT, 0 };
+static const int byte_sizes[] = { 80, 4000, 0 };
+
+static cell_t screen[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+static cell_t board[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+static char text[CONSOLE_WIDTH];
+
+/* The driver's text memory, mapped once */
+#define TEXT_MEMORY_BYTES 0x8000
+
+static const cell_t *text_memory = (const cell_t *)CONSOLE_MEM_BASE;
+static cell_t shadow[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+
+static void map_text(void)
+{
+  static int mapped;
+
+  if (!mapped) {
+    hosted_map(CONSOLE_MEM_BASE, TEXT_MEMORY_BYTES);
+    mapped = 1;
+  }
+}
+
+static void setup_cells(int size)
+{
+  int i;
+
+  for (i = 0; i < CONSOLE_WIDTH; i++)
+    text[i] = 'a' + i % 26;
+  for (i = 0; i < CONSOLE_HEIGHT * CONSOLE_WIDTH; i++)
+    board[i] = MAKE_CELL('#', i & 3);
+
+  cells_span(screen, text, CONSOLE_WIDTH, 0x1f);
+  if (CELL_CHAR(screen[3]) != 'd' || CELL_COLOR(screen[3]) != 0x1f)
+    bench_fail("console/span", "wrong cell");
+}
+
+static void run_span(int size)
+{
+  int row;
+
+  for (row = 0; row < size; row++)
+    cells_span(screen + row * CONSOLE_WIDTH, text, CONSOLE_WIDTH, 0x1f);
+  bench_sink += screen[0];
+}
+
+static void run_fill(int size)
+{
+  cells_fill(screen, CONSOLE_WIDTH, size, CONSOLE_WIDTH, MAKE_CELL(' ', 0x17));
+  bench_sink += screen[0];
+}
+
+static void run_copy(int size)
+{
+  cells_copy(screen, CONSOLE_WIDTH, board, CONSOLE_WIDTH, size, CONSOLE_WIDTH);
+  bench_sink += screen[0];
+}
+
+/* A sprite the size of the screen, a quarter of it transparent */
+static void run_copy_keyed(int size)
+{
+  cells_copy_keyed(screen, CONSOLE_WIDTH, board, CONSOLE_WIDTH, size,
+                   CONSOLE_WIDTH, MAKE_CELL('#', 0));
+  bench_sink += screen[0];
+}
+
+/* Output for putbytes(): lines of 79 letters, and the same lines with
+ * the color changed every eight letters */
+static char plain[4000];
+static char escaped[4000 * 2];
+static int escaped_len;
+
+/* Fails unless the display shows exactly what the console output goes to
+ * holds */
+static void check_screen(const char *name, const char *what)
+{
+  console_snapshot(shadow);
+  if (memcmp(shadow, text_memory + crtc_start(), sizeof(shadow)) != 0)
+    bench_fail(name, what);
+}
+
+/* Brings a console on screen while a frame is half drawn on it */
+static void check_switch_mid_frame(void)
+{
+  console_select(1);
+  putbytes("before\n", 7);
+  console_begin_frame();
+  putbytes("during\n", 7);
+  console_switch(1);
+  draw_char(5, 5, 'z', FGND_WHITE);
+  console_present();
+  check_screen("console/present", "switched mid-frame");
+  console_switch(0);
+  console_select(0);
+  check_screen("console/present", "switched back");
+}
+
+/* The driver's own putbytes(), on text memory in RAM.  Output scrolls the
+ * screen as it would in the kernel, with no scrollback kept. */
+static void setup_text(int size)
+{
+  static const char colors[] = "1234567";
+  static const char check[] =
+    "\033[2;3H\033[1;34;42mxy\033[0m\b\033[?25l\033[?25l\033[?25h";
+  int i, j = 0, row, col;
+
+  for (i = 0; i < size; i++) {
+    plain[i] = i % CONSOLE_WIDTH == CONSOLE_WIDTH - 1 ? '\n' : 'a' + i % 26;
+    if (i % 8 == 0) {
+      memcpy(escaped + j, "\033[3", 4);
+      escaped[j + 4] = colors[i / 8 % 7];
+      escaped[j + 5] = 'm';
+      j += 6;
+    }
+    escaped[j++] = plain[i];
+  }
+  escaped_len = j;
+
+  map_text();
+  set_term_color(FGND_WHITE);
+  clear_console();
+  putbytes(check, strlen(check));
+  get_cursor(&row, &col);
+  if (get_cell(1, 2) != MAKE_CELL('x', FGND_BBLUE | BGND_GREEN) ||
+      text_memory[CONSOLE_WIDTH + 2] != get_cell(1, 2))
+    bench_fail("console/putbytes", "escape misread");
+  if (row != 1 || col != 3 || get_char(1, 3) != ' ')
+    bench_fail("console/putbytes", "cursor or backspace misplaced");
+  if (get_cell(-1, 0) != MAKE_CELL(0, FGND_WHITE) ||
+      get_cell(CONSOLE_HEIGHT, 0) != MAKE_CELL(0, FGND_WHITE) ||
+      get_char(0, -1) != 0 || get_char(0, CONSOLE_WIDTH) != 0)
+    bench_fail("console/putbytes", "read off the screen");
+  if (ansi_plain_run(plain, size) != (size < CONSOLE_WIDTH ? size
+                                      : CONSOLE_WIDTH - 1))
+    bench_fail("console/putbytes", "run stopped in the wrong place");
+
+  /* Each size is whole lines, so the last is just above the cursor */
+  clear_console();
+  putbytes(plain, size);
+  get_cursor(&row, &col);
+  if (row == 0 || col != 0)
+    bench_fail("console/putbytes", "cursor misplaced");
+  for (i = 0; i < CONSOLE_WIDTH - 1; i++)
+    if (get_cell(row - 1, i) != MAKE_CELL(plain[size - CONSOLE_WIDTH + i],
+                                           FGND_WHITE))
+      bench_fail("console/putbytes", "text misplaced");
+  console_snapshot(shadow);
+  if (memcmp(shadow, text_memory, sizeof(shadow)) != 0)
+    bench_fail("console/putbytes", "text memory differs from the shadow");
+  set_cursor(0, 0);
+}
+
+/* The same through putbyte(), taking every byte the slow way */
+static void run_putbytes_bytewise(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    putbyte(plain[i]);
+  bench_sink += text_memory[0];
+}
+
+static void run_putbytes_plain(int size)
+{
+  putbytes(plain, size);
+  bench_sink += text_memory[0];
+}
+
+static void run_putbytes_escaped(int size)
+{
+  putbytes(escaped, escaped_len);
+  bench_sink += text_memory[0];
+}
+
+/* The driver's cell writers, through its shadow and onto text memory, each
+ * drawing size rows.  draw_char() is what drawing takes without the rest. */
+enum { DRAW_SPAN, DRAW_FILL, DRAW_BLIT };
+
+/* Draws an h x w rectangle at (row,col), which may be off the screen in
+ * part or whole, and checks that exactly its visible part changed */
+static void check_clip(int op, int row, int col, int h, int w)
+{
+  cell_t cell;
+  int r, c;
+
+  set_term_color(FGND_WHITE);
+  clear_console();
+  console_snapshot(screen);
+  switch (op) {
+  case DRAW_SPAN:
+    h = 1;
+    draw_span(row, col, text, w, 0x1f);
+    break;
+  case DRAW_FILL:
+    fill_rect(row, col, h, w, '#', 0x17);
+    break;
+  case DRAW_BLIT:
+    blit_cells(row, col, h, w, board, CONSOLE_WIDTH);
+    break;
+  }
+
+  for (r = 0; r < CONSOLE_HEIGHT; r++) {
+    for (c = 0; c < CONSOLE_WIDTH; c++) {
+      if (r < row || r >= row + h || c < col || c >= col + w)
+        continue;
+      if (op == DRAW_SPAN)
+        cell = MAKE_CELL(text[c - col], 0x1f);
+      else if (op == DRAW_FILL)
+        cell = MAKE_CELL('#', 0x17);
+      else
+        cell = board[(r - row) * CONSOLE_WIDTH + c - col];
+      screen[r * CONSOLE_WIDTH + c] = cell;
+    }
+  }
+  check_screen("console/draw", "text memory differs from the shadow");
+  if (memcmp(shadow, screen, sizeof(shadow)) != 0)
+    bench_fail("console/draw", "clipped wrongly");
+}
+
+static void setup_draw(int size)
+{
+  /* Over each edge, past a corner, covering the screen, and off it */
+  static const int rects[][4] = {
+    { -2, -3, 5, 10 }, { 22, 75, 6, 10 }, { 3, -7, 2, 80 },
+    { -1, -1, CONSOLE_HEIGHT, CONSOLE_WIDTH }, { -30, 0, 5, 80 },
+    { 0, CONSOLE_WIDTH, 3, 3 }, { CONSOLE_HEIGHT, 0, 1, 80 },
+    { 4, 4, 0, 5 }, { 4, 4, 3, -2 },
+  };
+  int i, op;
+
+  setup_cells(size);
+  map_text();
+  for (op = DRAW_SPAN; op <= DRAW_BLIT; op++)
+    for (i = 0; i < (int)(sizeof(rects) / sizeof(rects[0])); i++)
+      check_clip(op, rects[i][0], rects[i][1], rects[i][2], rects[i][3]);
+  clear_console();
+}
+
+static void run_draw_char(int size)
+{
+  int row, col;
+
+  for (row = 0; row < size; row++)
+    for (col = 0; col < CONSOLE_WIDTH; col++)
+      draw_char(row, col, text[col], 0x1f);
+  bench_sink += text_memory[0];
+}
+
+static void run_draw_span(int size)
+{
+  int row;
+
+  for (row = 0; row < size; row++)
+    draw_span(row, 0, text, CONSOLE_WIDTH, 0x1f);
+  bench_sink += text_memory[0];
+}
+
+static void run_fill_rect(int size)
+{
+  fill_rect(0, 0, size, CONSOLE_WIDTH, ' ', 0x17);
+  bench_sink += text_memory[0];
+}
+
+static void run_blit_cells(int size)
+{
+  blit_cells(0, 0, size, CONSOLE_WIDTH, board, CONSOLE_WIDTH);
+  bench_sink += text_memory[0];
+}
+
+/* Two frames for the recorder: a screen of colored text, and the same
+ * with a word of each of the first size rows changed and highlighted */
+static cell_t frame_prev[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+static cell_t frame_next[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+static unsigned char frame_buf[FR_MAX_FRAME];
+static int frame_len;
+
+static void setup_frames(int size)
+{
+  int i, row;
+
+  for (i = 0; i < CONSOLE_HEIGHT * CONSOLE_WIDTH; i++)
+    frame_prev[i] = MAKE_CELL(i % 7 ? 'a' + i % 26 : ' ', 0x07 + (i / 20 % 2));
+  memcpy(frame_next, frame_prev, sizeof(frame_next));
+  for (row = 0; row < size; row++)
+    for (i = 30; i < 38; i++)
+      frame_next[row * CONSOLE_WIDTH + i] = MAKE_CELL('A' + row, 0x70);
+
+  frame_len = framerec_diff(frame_prev, frame_next, frame_buf);
+  memcpy(screen, frame_prev, sizeof(screen));
+  if (framerec_apply(screen, frame_buf, frame_len) != frame_len ||
+      memcmp(screen, frame_next, sizeof(screen)) != 0)
+    bench_fail("console/frame", "diff doesn't play back");
+
+  memset(screen, 0, sizeof(screen));
+  i = framerec_diff(NULL, frame_next, frame_buf);
+  if (framerec_apply(screen, frame_buf, i) != i ||
+      memcmp(screen, frame_next, sizeof(screen)) != 0)
+    bench_fail("console/frame", "keyframe doesn't play back");
+
+  frame_len = framerec_diff(frame_prev, frame_next, frame_buf);
+}
+
+static void run_frame_diff(int size)
+{
+  bench_sink += framerec_diff(frame_prev, frame_next, frame_buf);
+}
+
+static void run_frame_apply(int size)
+{
+  bench_sink += framerec_apply(screen, frame_buf, frame_len);
+}
+
+/* Memory for console_init() to size the consoles' history by, as the
+ * kernel's free memory would be; the history itself is malloc()ed */
+static char heap[1 << 19];
+
+/* Lines for the consoles' history and windows: a letter repeated */
+static void put_lines(int n)
+{
+  char line[11];
+  int i;
+
+  for (i = 0; i < n; i++) {
+    memset(line, 'a' + i % 26, 10);
+    line[10] = '\n';
+    putbytes(line, 11);
+  }
+}
+
+/* Frames, the view into history, and switches between consoles all leave
+ * the display showing what the console holds.  From here on the consoles
+ * keep history. */
+static void setup_pages(int size)
+{
+  static lmm_region_t region;
+  static int given;
+
+  setup_cells(size);
+  map_text();
+  if (!given) {
+    lmm_add_region(&malloc_lmm, &region, heap, sizeof(heap), 0, 0);
+    lmm_add_free(&malloc_lmm, heap, sizeof(heap));
+    console_init();
+    given = 1;
+  }
+
+  set_term_color(FGND_WHITE);
+  clear_console();
+  put_lines(2 * CONSOLE_HEIGHT);
+  check_screen("console/present", "scrolled");
+
+  /* History above, the top of the live screen below */
+  if (console_view(5) != 5)
+    bench_fail("console/present", "no history kept");
+  console_snapshot(shadow);
+  if (memcmp(shadow, text_memory + crtc_start() + 5 * CONSOLE_WIDTH,
+             (CONSOLE_HEIGHT - 5) * CONSOLE_WIDTH * sizeof(cell_t)) != 0)
+    bench_fail("console/present", "view misplaced");
+  console_view(0);
+  check_screen("console/present", "view and back");
+  console_scroll_view(3);
+  putbytes("x", 1);
+  check_screen("console/present", "output while viewing");
+
+  /* The second frame goes on the page the first was drawn over */
+  console_begin_frame();
+  draw_span(2, 0, text, 9, 0x1e);
+  console_present();
+  check_screen("console/present", "first frame");
+  console_begin_frame();
+  fill_rect(10, 10, 3, 20, '*', 0x4f);
+  console_present();
+  check_screen("console/present", "second frame");
+
+  /* Output goes on to console 2 while it's off screen */
+  console_select(2);
+  putbytes("off screen\n", 11);
+  console_switch(2);
+  check_screen("console/present", "switched");
+  console_select(0);
+  console_switch(0);
+  check_screen("console/present", "switched back");
+  console_view(2);
+  console_switch(1);
+  console_select(1);
+  check_screen("console/present", "switched from history");
+  console_select(0);
+  console_switch(0);
+  check_screen("console/present", "switched back from history");
+
+  check_switch_mid_frame();
+  clear_console();
+}
+
+/* A frame redrawing the size's rows, in a color that changes each call */
+static void run_present(int size)
+{
+  static int color;
+  int row;
+
+  color ^= 0x10;
+  console_begin_frame();
+  for (row = 0; row < size; row++)
+    draw_span(row, 0, text, CONSOLE_WIDTH, 0x0f | color);
+  console_present();
+  bench_sink += crtc_start();
+}
+
+/* A sprite size rows high, with transparent corners, over the board */
+#define SPRITE_WIDTH 8
+#define SPRITE_KEY MAKE_CELL(' ', 0)
+
+static cell_t sprite_cells[CONSOLE_HEIGHT * SPRITE_WIDTH];
+static cell_t sprite_saved[CONSOLE_HEIGHT * SPRITE_WIDTH];
+static sprite_t sprite;
+
+/* Fails unless the screen is the board, with the sprite at (x,y) on top */
+static void check_sprite(int x, int y, const char *what)
+{
+  cell_t cell;
+  int r, c;
+
+  for (r = 0; r < CONSOLE_HEIGHT; r++) {
+    for (c = 0; c < CONSOLE_WIDTH; c++) {
+      cell = board[r * CONSOLE_WIDTH + c];
+      if (r >= y && r < y + sprite.height && c >= x && c < x + SPRITE_WIDTH &&
+          sprite_cells[(r - y) * SPRITE_WIDTH + c - x] != SPRITE_KEY)
+        cell = sprite_cells[(r - y) * SPRITE_WIDTH + c - x];
+      screen[r * CONSOLE_WIDTH + c] = cell;
+    }
+  }
+  check_screen("console/sprite-move", "text memory differs from the shadow");
+  if (memcmp(shadow, screen, sizeof(shadow)) != 0)
+    bench_fail("console/sprite-move", what);
+}
+
+static void setup_sprite(int size)
+{
+  /* Over each edge and corner, and off the screen */
+  static const int moves[][2] = {
+    { -3, -2 }, { 76, 22 }, { 40, 10 }, { -8, 0 }, { 78, -1 },
+    { 0, CONSOLE_HEIGHT }, { -1, 20 },
+  };
+  int i, r, c;
+
+  setup_cells(size);
+  map_text();
+  for (r = 0; r < size; r++)
+    for (c = 0; c < SPRITE_WIDTH; c++)
+      sprite_cells[r * SPRITE_WIDTH + c] =
+        (r == 0 || r == size - 1) && (c == 0 || c == SPRITE_WIDTH - 1)
+        ? SPRITE_KEY : MAKE_CELL('@', 0x0e);
+
+  blit_cells(0, 0, CONSOLE_HEIGHT, CONSOLE_WIDTH, board, CONSOLE_WIDTH);
+  sprite_init(&sprite, SPRITE_WIDTH, size, sprite_cells, SPRITE_KEY,
+              sprite_saved);
+  for (i = 0; i < (int)(sizeof(moves) / sizeof(moves[0])); i++) {
+    sprite_move(moves[i][0], moves[i][1], &sprite);
+    check_sprite(moves[i][0], moves[i][1], "background not restored");
+  }
+  sprite_erase(&sprite);
+  check_sprite(0, CONSOLE_HEIGHT, "erase left the sprite behind");
+}
+
+/* One step across the screen */
+static void run_sprite_move(int size)
+{
+  static int x;
+
+  x = (x + 1) % (CONSOLE_WIDTH - SPRITE_WIDTH);
+  sprite_move(x, 0, &sprite);
+  bench_sink += text_memory[x];
+}
+
+/* A window of short lines, wrapping and scrolling, and the output for it */
+#define WIN_TOP 5
+#define WIN_LEFT 10
+#define WIN_WIDTH 12
+
+static window_t win;
+
+/* Sets the expected screen's row of the window to s, then blanks */
+static void expect_row(window_t *w, int row, const char *s)
+{
+  cell_t *cells = screen + (w->top + row) * CONSOLE_WIDTH + w->left;
+  int i, n = strlen(s);
+
+  for (i = 0; i < w->width; i++)
+    cells[i] = MAKE_CELL(i < n ? s[i] : 0, w->color);
+}
+
+static void check_window(const char *what)
+{
+  check_screen("console/window", "text memory differs from the shadow");
+  if (memcmp(shadow, screen, sizeof(shadow)) != 0)
+    bench_fail("console/window", what);
+}
+
+static void setup_window(int size)
+{
+  window_t clip;
+  int i;
+
+  setup_cells(size);
+  map_text();
+  for (i = 0; i < size; i++)
+    plain[i] = i % 9 == 8 ? '\n' : 'a' + i % 26;
+
+  blit_cells(0, 0, CONSOLE_HEIGHT, CONSOLE_WIDTH, board, CONSOLE_WIDTH);
+  memcpy(screen, board, sizeof(screen));
+  window_init(&win, WIN_TOP, WIN_LEFT, 4, WIN_WIDTH, 0x1f,
+              WINDOW_WRAP | WINDOW_SCROLL);
+  window_clear(&win);
+  window_putbytes(&win, "abcdefghijklmnopqrstuvwxyz", 26);
+  expect_row(&win, 0, "abcdefghijkl");
+  expect_row(&win, 1, "mnopqrstuvwx");
+  expect_row(&win, 2, "yz");
+  expect_row(&win, 3, "");
+  check_window("didn't wrap");
+
+  window_putbytes(&win, "\n1\n2\n3", 6);
+  expect_row(&win, 0, "yz");
+  expect_row(&win, 1, "1");
+  expect_row(&win, 2, "2");
+  expect_row(&win, 3, "3");
+  check_window("didn't scroll");
+
+  window_scroll(&win, -1);
+  expect_row(&win, 0, "");
+  expect_row(&win, 1, "yz");
+  expect_row(&win, 2, "1");
+  expect_row(&win, 3, "2");
+  check_window("didn't scroll back");
+
+  /* Clipped to two rows of six at the corner; without wrapping the rest
+   * of a long line goes, and without scrolling the cursor goes back to
+   * the top, writing over what's there */
+  window_init(&clip, CONSOLE_HEIGHT - 2, CONSOLE_WIDTH - 6, 4, 10, 0x2e, 0);
+  window_clear(&clip);
+  window_putbytes(&clip, "abcdefghij\nkl\nmn\nop", 19);
+  expect_row(&clip, 0, "mncdef");
+  expect_row(&clip, 1, "op");
+  check_window("didn't clip or go back to the top");
+
+  window_clear(&win);
+}
+
+static void run_window(int size)
+{
+  window_putbytes(&win, plain, size);
+  bench_sink += text_memory[WIN_TOP * CONSOLE_WIDTH + WIN_LEFT];
+}
+
+/* What the recorder sent, and the last frame in it */
+static unsigned char recorded[RECORD_RING_SIZE];
+static cell_t sent[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+
+/* Plays every frame in the ring back onto screen, and fails unless it then
+ * shows the last frame sent */
+static void check_recording(const char *what)
+{
+  int len = recorder_read(recorded, sizeof(recorded));
+  int at, n;
+
+  for (at = 0; at < len; at += n)
+    if ((n = framerec_apply(screen, recorded + at, len - at)) < 0)
+      bench_fail("console/recorder", "malformed frame");
+  if (memcmp(sent, screen, sizeof(screen)) != 0)
+    bench_fail("console/recorder", what);
+}
+
+static void setup_recorder(int size)
+{
+  int i, frames;
+
+  setup_cells(size);
+  map_text();
+  blit_cells(0, 0, CONSOLE_HEIGHT, CONSOLE_WIDTH, board, CONSOLE_WIDTH);
+  memset(screen, 0, sizeof(screen));
+  recorder_start(RECORD_RING);
+  if (recorder_frame() <= 0)
+    bench_fail("console/recorder", "keyframe not sent");
+  console_snapshot(sent);
+  check_recording("keyframe doesn't play back");
+
+  for (i = 0; i < 3; i++) {
+    draw_span(i * 7, i, text, 20, 0x1a + i);
+    recorder_frame();
+  }
+  console_snapshot(sent);
+  check_recording("diffs don't play back");
+
+  /* Frames that don't fit are dropped, and the next after a read is sent
+   * whole */
+  for (frames = 0; recorder_frame() >= 0; frames++) {
+    console_snapshot(sent);
+    draw_span(frames % CONSOLE_HEIGHT, 0, text, CONSOLE_WIDTH,
+              0x10 + frames % 7);
+  }
+  if (frames == 0)
+    bench_fail("console/recorder", "ring full too soon");
+  check_recording("frames before the drop don't play back");
+  fill_rect(3, 3, 4, 40, '+', 0x3c);
+  if (recorder_frame() < FR_MAX_FRAME / 4)
+    bench_fail("console/recorder", "no keyframe after the drop");
+  console_snapshot(sent);
+  check_recording("keyframe after the drop doesn't play back");
+}
+
+/* A frame changing the size's rows, read out of the ring */
+static void run_recorder(int size)
+{
+  static int color;
+
+  color ^= 0x10;
+  fill_rect(0, 0, size, CONSOLE_WIDTH, '.', 0x0f | color);
+  recorder_frame();
+  bench_sink += recorder_read(recorded, sizeof(recorded));
+}
+
+const bench_t bench_console[] = {
+  { "console/span",       row_sizes, setup_cells, run_span,       0 },
+  { "console/fill",       row_sizes, setup_cells, run_fill,       0 },
+  { "console/copy",       row_sizes, setup_cells, run_copy,       0 },
+  { "console/copy-keyed", row_sizes, setup_cells, run_copy_keyed, 0 },
+  { "console/draw_char",  row_sizes, setup_draw, run_draw_char,  0 },
+  { "console/draw_span",  row_sizes, setup_draw, run_draw_span,  0 },
+  { "console/fill_rect",  row_sizes, setup_draw, run_fill_rect,  0 },
+  { "console/blit_cells", row_sizes, setup_draw, run_blit_cells, 0 },
+  { "console/putbytes-bytewise", byte_sizes, setup_text, run_putbytes_bytewise, 0 },
+  { "console/putbytes-plain",    byte_sizes, setup_text, run_putbytes_plain,    0 },
+  { "console/putbytes-escaped",  byte_sizes, setup_text, run_putbytes_escaped,  0 },
+  { "console/frame-diff",  row_sizes, setup_frames, run_frame_diff,  0 },
+  { "console/frame-apply", row_sizes, setup_frames, run_frame_apply, 0 },
+  { "console/present",     row_sizes, setup_pages,    run_present,     0 },
+  { "console/sprite-move", row_sizes, setup_sprite,   run_sprite_move, 0 },
+  { "console/window",      byte_sizes, setup_window,  run_window,      0 },
+  { "console/recorder",    row_sizes, setup_recorder, run_recorder,    0 },
+  { 0 }
+};
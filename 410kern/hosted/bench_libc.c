@@ -0,0 +1,445 @@
+/** @file bench_libc.c
+ *  @brief Benchmarks for libstring, libstdlib, libstdio and libRNG.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <mt19937int.h>
+#include <pcg32.h>
+#include <sortgen.h>
+#include <texttwist_dict.h>
+#include "bench.h"
+
+#define MAX_BYTES 65536
+#define MAX_ELTS  4096
+
+static const int byte_sizes[] = { 16, 256, 4096, MAX_BYTES, 0 };
+static const int text_sizes[] = { 256, 4096, 32768, 0 };
+static const int elt_sizes[] = { 16, 256, MAX_ELTS, 0 };
+static const int one_size[] = { 1, 0 };
+
+static char src[MAX_BYTES + 1];
+static char dst[MAX_BYTES + 1];
+static int keys[MAX_ELTS];
+static int work[MAX_ELTS];
+static uint32_t words[MAX_ELTS];
+static pcg32_t rng;
+
+/* ---- libstring ---- */
+
+static void setup_bytes(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    src[i] = 'a' + i % 26;
+  src[size] = '\0';
+}
+
+static void run_memcpy(int size)
+{
+  memcpy(dst, src, size);
+  bench_sink += dst[size - 1];
+}
+
+static void run_memset(int size)
+{
+  memset(dst, size, size);
+  bench_sink += dst[0];
+}
+
+static void run_strlen(int size)
+{
+  bench_sink += strlen(src);
+}
+
+static char needle[32];
+
+/* A prefix of the texttwist dictionary, which is what games search.  The
+ * needle for hits is the prefix's last complete word, space included. */
+static void setup_text(int size)
+{
+  int start, end;
+
+  memcpy(src, texttwist_dict, size);
+  src[size] = '\0';
+
+  end = size - 1;
+  while (end > 0 && src[end] != ' ')
+    end--;
+  start = end - 1;
+  while (start > 0 && src[start - 1] != ' ')
+    start--;
+  memcpy(needle, &src[start], end - start + 1);
+  needle[end - start + 1] = '\0';
+}
+
+static void run_strstr_miss(int size)
+{
+  if (strstr(src, "qzqzq") != 0)
+    bench_fail("strstr", "found a word that is not there");
+  bench_sink++;
+}
+
+static void run_strstr_hit(int size)
+{
+  char *p = strstr(src, needle);
+
+  if (p == 0)
+    bench_fail("strstr", "missed a word that is there");
+  bench_sink += p - src;
+}
+
+static void run_memmem_hit(int size)
+{
+  static const char word[] = "zephyr zero";
+  static size_t dict_len;
+  char *p;
+
+  if (dict_len == 0)
+    dict_len = strlen(texttwist_dict);
+  p = memmem(texttwist_dict, dict_len, word, sizeof(word) - 1);
+
+  if (p == 0)
+    bench_fail("memmem", "missed a word that is there");
+  bench_sink += p - texttwist_dict;
+}
+
+/* ---- libstdlib ---- */
+
+/* Comparisons qsort() made in the last run */
+static unsigned long compares;
+
+static int cmp_int(const void *a, const void *b)
+{
+  int x = *(const int *)a, y = *(const int *)b;
+
+  compares++;
+  return x < y ? -1 : x > y;
+}
+
+/* McIlroy's adversary: every key starts as "gas", worth more than any
+ * settled key, and a key is settled only when the sort compares two gas
+ * keys, in the way that makes the likely pivot as bad as possible.
+ * Sorting the settled keys again takes the same path, so they are a
+ * worst case for whichever sort was run against the adversary. */
+static int adv_key[MAX_ELTS];
+static int adv_gas, adv_solid, adv_candidate;
+
+static int adv_cmp(int x, int y)
+{
+  if (adv_key[x] == adv_gas && adv_key[y] == adv_gas) {
+    if (x == adv_candidate)
+      adv_key[x] = adv_solid++;
+    else
+      adv_key[y] = adv_solid++;
+  }
+  if (adv_key[x] == adv_gas)
+    adv_candidate = x;
+  else if (adv_key[y] == adv_gas)
+    adv_candidate = y;
+  return adv_key[x] < adv_key[y] ? -1 : adv_key[x] > adv_key[y];
+}
+
+static int adv_cmp_ptr(const void *a, const void *b)
+{
+  return adv_cmp(*(const int *)a, *(const int *)b);
+}
+
+/* qsort_int() as sortgen.h builds it, with the adversary deciding the
+ * comparisons, and again counting them */
+#define ADV_LESS(x, y) (adv_cmp(*(x), *(y)) < 0)
+#define COUNTED_LESS(x, y) (compares++, *(x) < *(y))
+SORTGEN_DEFINE(static, adv_sort_int, int, ADV_LESS)
+SORTGEN_DEFINE(static, counted_sort_int, int, COUNTED_LESS)
+
+enum {
+  KEYS_RANDOM,
+  KEYS_SORTED,
+  KEYS_REVERSED,
+  KEYS_EQUAL,
+  KEYS_KILL_QSORT,      /* the adversary's keys against qsort() */
+  KEYS_KILL_QSORT_INT,  /* ... and against qsort_int() */
+};
+
+static int keys_pattern = -1;
+static int keys_size;
+
+static void make_keys(int size, int pattern)
+{
+  int i;
+
+  switch (pattern) {
+  case KEYS_RANDOM:
+    pcg32_seed(&rng, 410, 1);
+    for (i = 0; i < size; i++)
+      keys[i] = pcg32_next(&rng) & 0x7fffffff;
+    break;
+  case KEYS_SORTED:
+    for (i = 0; i < size; i++)
+      keys[i] = i;
+    break;
+  case KEYS_REVERSED:
+    for (i = 0; i < size; i++)
+      keys[i] = size - i;
+    break;
+  case KEYS_EQUAL:
+    for (i = 0; i < size; i++)
+      keys[i] = 410;
+    break;
+  default:
+    adv_gas = size;
+    adv_solid = 0;
+    adv_candidate = 0;
+    for (i = 0; i < size; i++) {
+      adv_key[i] = adv_gas;
+      work[i] = i;
+    }
+    if (pattern == KEYS_KILL_QSORT)
+      qsort(work, size, sizeof(int), adv_cmp_ptr);
+    else
+      adv_sort_int(work, size);
+    memcpy(keys, adv_key, size * sizeof(int));
+    break;
+  }
+  keys_pattern = pattern;
+  keys_size = size;
+}
+
+/* Most comparisons an O(n log n) sort of n keys should need: the
+ * partitioning rounds introsort allows before heapsort, then heapsort */
+static unsigned long compare_limit(int n)
+{
+  unsigned long lg = 1;
+
+  while ((1 << lg) < n)
+    lg++;
+  return 6 * n * lg;
+}
+
+/* The last sort is checked here rather than in the timed run() */
+static const char *sorted_name;
+static int sorted_size;
+static unsigned long keys_sum;
+
+static void check_sort(void)
+{
+  unsigned long sum = 0;
+  int i;
+
+  if (sorted_size == 0)
+    return;
+  for (i = 1; i < sorted_size; i++)
+    if (work[i - 1] > work[i])
+      bench_fail(sorted_name, "output not sorted");
+  for (i = 0; i < sorted_size; i++)
+    sum += work[i];
+  if (sum != keys_sum)
+    bench_fail(sorted_name, "output not the input reordered");
+  if (compares > compare_limit(sorted_size))
+    bench_fail(sorted_name, "quadratic on this input");
+  sorted_size = 0;
+}
+
+/* Sorting consumes its input, so these run with per_call_setup */
+static void setup_sort(int size, int pattern)
+{
+  int i;
+
+  check_sort();
+  if (pattern != keys_pattern || size != keys_size) {
+    make_keys(size, pattern);
+    if (pattern == KEYS_KILL_QSORT_INT) {
+      /* qsort_int() can't count, so count its twin once here */
+      memcpy(work, keys, size * sizeof(int));
+      compares = 0;
+      counted_sort_int(work, size);
+      if (compares > compare_limit(size))
+        bench_fail("qsort_int/killer", "quadratic on this input");
+    }
+  }
+  memcpy(work, keys, size * sizeof(int));
+  keys_sum = 0;
+  for (i = 0; i < size; i++)
+    keys_sum += keys[i];
+  compares = 0;
+}
+
+static void setup_random(int size)    { setup_sort(size, KEYS_RANDOM); }
+static void setup_sorted(int size)    { setup_sort(size, KEYS_SORTED); }
+static void setup_reversed(int size)  { setup_sort(size, KEYS_REVERSED); }
+static void setup_equal(int size)     { setup_sort(size, KEYS_EQUAL); }
+static void setup_kill_qsort(int size)     { setup_sort(size, KEYS_KILL_QSORT); }
+static void setup_kill_qsort_int(int size) { setup_sort(size, KEYS_KILL_QSORT_INT); }
+
+static void run_qsort(int size)
+{
+  qsort(work, size, sizeof(int), cmp_int);
+  sorted_name = "qsort";
+  sorted_size = size;
+}
+
+static void run_qsort_int(int size)
+{
+  qsort_int(work, size);
+  sorted_name = "qsort_int";
+  sorted_size = size;
+}
+
+static void run_rand_mod(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    bench_sink += rand() % 6;
+}
+
+/* ---- libstdio ---- */
+
+static void run_snprintf(int size)
+{
+  int n = snprintf(dst, MAX_BYTES, "level %d score %x name %s",
+                   1234, 0xbeef, "player");
+
+  if (strcmp(dst, "level 1234 score beef name player"))
+    bench_fail("snprintf", "wrong output");
+  bench_sink += n;
+}
+
+static void run_sscanf(int size)
+{
+  int a = 0, b = 0;
+  char name[16];
+
+  sscanf("1234 5678 player", "%d %d %s", &a, &b, name);
+  if (a != 1234 || b != 5678 || strcmp(name, "player"))
+    bench_fail("sscanf", "wrong values");
+  bench_sink += a + b;
+}
+
+/* A string of size letters, printed and scanned whole */
+static void run_snprintf_str(int size)
+{
+  int n = snprintf(dst, MAX_BYTES + 1, "%s", src);
+
+  if (n != size || dst[size - 1] != src[size - 1])
+    bench_fail("snprintf/%s", "wrong output");
+  bench_sink += n;
+}
+
+static void run_sscanf_str(int size)
+{
+  dst[size - 1] = '\0';
+  sscanf(src, "%s", dst);
+  if (dst[size - 1] != src[size - 1] || dst[size] != '\0')
+    bench_fail("sscanf/%s", "wrong value");
+  bench_sink += dst[0];
+}
+
+/* ---- libRNG ---- */
+
+static void run_genrand(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    bench_sink += genrand();
+}
+
+/* genrand_fill() must give what the same number of genrand() calls
+ * would, including across the regenerations of the 624-word state, and
+ * leave genrand() to carry on from where it stopped */
+static void setup_genrand_fill(int size)
+{
+  static uint32_t expect[1500];
+  int i;
+
+  sgenrand(4357);
+  for (i = 0; i < 1500; i++)
+    expect[i] = genrand();
+
+  sgenrand(4357);
+  genrand_fill(words, 100);
+  genrand_fill(words, 1000);
+  for (i = 0; i < 1000; i++)
+    if (words[i] != expect[100 + i])
+      bench_fail("genrand_fill", "differs from genrand()");
+  for (i = 1100; i < 1500; i++)
+    if ((uint32_t)genrand() != expect[i])
+      bench_fail("genrand_fill", "genrand() lost its place");
+}
+
+static void run_genrand_fill(int size)
+{
+  genrand_fill(words, size);
+  bench_sink += words[size - 1];
+}
+
+static void run_pcg32_fill(int size)
+{
+  pcg32_fill(&rng, words, size);
+  bench_sink += words[size - 1];
+}
+
+/* Every result below the bound, and for a small bound, every value
+ * turns up */
+static void setup_pcg32_bounded(int size)
+{
+  static const uint32_t bounds[] = { 1, 6, 7, 1000, 0x80000001u, 0xffffffffu };
+  uint32_t seen, x;
+  unsigned int b;
+  int i;
+
+  pcg32_seed(&rng, 410, 2);
+  for (b = 0; b < sizeof(bounds) / sizeof(bounds[0]); b++) {
+    seen = 0;
+    for (i = 0; i < 10000; i++) {
+      x = pcg32_bounded(&rng, bounds[b]);
+      if (x >= bounds[b])
+        bench_fail("pcg32_bounded", "result out of range");
+      if (x < 32)
+        seen |= 1u << x;
+    }
+    if (bounds[b] <= 7 && seen != (1u << bounds[b]) - 1)
+      bench_fail("pcg32_bounded", "a value never came up");
+  }
+}
+
+static void run_pcg32_bounded(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    bench_sink += pcg32_bounded(&rng, 6);
+}
+
+const bench_t bench_libc[] = {
+  { "memcpy",          byte_sizes, setup_bytes, run_memcpy,        0 },
+  { "memset",          byte_sizes, setup_bytes, run_memset,        0 },
+  { "strlen",          byte_sizes, setup_bytes, run_strlen,        0 },
+  { "strstr/miss",     text_sizes, setup_text,  run_strstr_miss,   0 },
+  { "strstr/hit",      text_sizes, setup_text,  run_strstr_hit,    0 },
+  { "memmem/dict",     one_size,   0,           run_memmem_hit,    0 },
+  { "qsort",           elt_sizes,  setup_random,   run_qsort,      1 },
+  { "qsort/sorted",    elt_sizes,  setup_sorted,   run_qsort,      1 },
+  { "qsort/reversed",  elt_sizes,  setup_reversed, run_qsort,      1 },
+  { "qsort/equal",     elt_sizes,  setup_equal,    run_qsort,      1 },
+  { "qsort/killer",    elt_sizes,  setup_kill_qsort, run_qsort,    1 },
+  { "qsort_int",       elt_sizes,  setup_random,   run_qsort_int,  1 },
+  { "qsort_int/sorted",   elt_sizes, setup_sorted,   run_qsort_int, 1 },
+  { "qsort_int/reversed", elt_sizes, setup_reversed, run_qsort_int, 1 },
+  { "qsort_int/equal",    elt_sizes, setup_equal,    run_qsort_int, 1 },
+  { "qsort_int/killer",   elt_sizes, setup_kill_qsort_int, run_qsort_int, 1 },
+  { "snprintf",        one_size,   0,           run_snprintf,      0 },
+  { "sscanf",          one_size,   0,           run_sscanf,        0 },
+  { "snprintf/%s",     byte_sizes, setup_bytes, run_snprintf_str,  0 },
+  { "sscanf/%s",       byte_sizes, setup_bytes, run_sscanf_str,    0 },
+  { "rand%6",          elt_sizes,  0,           run_rand_mod,      0 },
+  { "genrand",         elt_sizes,  0,           run_genrand,       0 },
+  { "genrand_fill",    elt_sizes,  setup_genrand_fill, run_genrand_fill, 0 },
+  { "pcg32_fill",      elt_sizes,  0,           run_pcg32_fill,    0 },
+  { "pcg32_bounded",   elt_sizes,  setup_pcg32_bounded, run_pcg32_bounded, 0 },
+  { 0 }
+};
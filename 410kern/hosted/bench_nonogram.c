@@ -0,0 +1,186 @@
+/** @file bench_nonogram.c
+ *  @brief Benchmarks for the nonogram solver in 410kern/misc.
+ */
+
+#include <string.h>
+#include <nonogram_db.h>
+#include <nonogram_solver.h>
+#include <nonogram_gen.h>
+#include <mt19937int.h>
+#include "bench.h"
+
+static const int one_size[] = { 1, 0 };
+
+/* Generated layouts are size x size */
+static const int gen_sizes[] = { 5, 10, 0 };
+
+#define GEN_BUDGET 100000
+
+static ng_compiled_t compiled[16];
+
+/* Checks that a solved board satisfies every clue of its layout */
+static int check_solution(const ng_compiled_t *lay, const ng_board_t *b)
+{
+  ng_line_t col;
+  int r, c;
+
+  for (r = 0; r < lay->rows; r++)
+    if (b->empty[r] != (((1u << lay->cols) - 1) & ~b->filled[r]) ||
+        !ng_line_matches(lay, NG_ROW_LINE(lay, r), b->filled[r]))
+      return 0;
+  for (c = 0; c < lay->cols; c++) {
+    for (col = 0, r = 0; r < lay->rows; r++)
+      col |= ((b->filled[r] >> c) & 1) << r;
+    if (!ng_line_matches(lay, NG_COL_LINE(lay, c), col))
+      return 0;
+  }
+  return 1;
+}
+
+static void setup_layouts(int size)
+{
+  ng_board_t solution;
+  int i;
+
+  if (ng_layout_count > sizeof(compiled) / sizeof(compiled[0]))
+    bench_fail("nonogram", "too many layouts");
+  for (i = 0; i < ng_layout_count; i++) {
+    if (ng_compile(&ng_layouts[i], &compiled[i]) < 0)
+      bench_fail("nonogram/compile", "rejected a layout");
+    if (ng_solve(&compiled[i], &solution, 1) != 1)
+      bench_fail("nonogram/solve", "layout has no solution");
+    if (!check_solution(&compiled[i], &solution))
+      bench_fail("nonogram/solve", "solution breaks a clue");
+  }
+}
+
+/* Solves every layout, as a game would to validate them at boot */
+static void run_validate(int size)
+{
+  ng_board_t solution;
+  int i;
+
+  for (i = 0; i < ng_layout_count; i++)
+    bench_sink += ng_solve(&compiled[i], &solution, 2);
+}
+
+static void run_solve(int size)
+{
+  ng_board_t solution;
+  int i;
+
+  for (i = 0; i < ng_layout_count; i++)
+    bench_sink += ng_solve(&compiled[i], &solution, 1);
+}
+
+static void run_compile(int size)
+{
+  int i;
+
+  for (i = 0; i < ng_layout_count; i++)
+    bench_sink += ng_compile(&ng_layouts[i], &compiled[i]);
+}
+
+/* Totals the clues of every line, as drawing the clue headers does, by
+ * walking the run arrays of the layouts */
+static void run_clues_walk(int size)
+{
+  const ng_layout_t *l;
+  const int *runs;
+  int i, line, total = 0;
+
+  for (l = ng_layouts; l < ng_layouts + ng_layout_count; l++) {
+    for (line = 0; line < l->rows + l->cols; line++) {
+      runs = line < l->rows ? l->row_runs : l->col_runs;
+      for (i = line < l->rows ? line : line - l->rows; i > 0; runs++)
+        if (*runs == NG_RUN_END)
+          i--;
+      for (; *runs != NG_RUN_END; runs++)
+        total += *runs;
+    }
+  }
+  bench_sink += total;
+}
+
+/* The same from the compiled tables */
+static void run_clues_index(int size)
+{
+  const ng_compiled_t *lay;
+  int i, line, total = 0;
+
+  for (lay = compiled; lay < compiled + ng_layout_count; lay++)
+    for (line = 0; line < lay->rows + lay->cols; line++)
+      for (i = 0; i < lay->nruns[line]; i++)
+        total += NG_LINE_RUNS(lay, line)[i];
+  bench_sink += total;
+}
+
+/* A 10 cell line with one cell known, as when the player marks a cell */
+static void run_line(int size)
+{
+  static const unsigned char runs[] = { 3, 1, 2 };
+  ng_line_t filled = 1u << 5, empty = 0;
+
+  if (ng_line_solve(runs, 3, 10, &filled, &empty) != 1)
+    bench_fail("nonogram/line", "deduced nothing");
+  bench_sink += filled + empty;
+}
+
+static void check_generate(int size, int difficulty)
+{
+  ng_layout_t layout;
+  ng_compiled_t lay;
+  ng_board_t solution, check;
+
+  sgenrand(4357);
+  if (ng_generate(size, size, difficulty, &layout, &solution, GEN_BUDGET) < 0)
+    bench_fail("nonogram/generate", "budget ran out");
+  if (ng_compile(&layout, &lay) < 0 || ng_solve(&lay, &check, 2) != 1)
+    bench_fail("nonogram/generate", "layout isn't unique");
+  if (memcmp(check.filled, solution.filled, sizeof(check.filled)) != 0 ||
+      !check_solution(&lay, &solution))
+    bench_fail("nonogram/generate", "wrong solution");
+}
+
+static void setup_generate_lines(int size)
+{
+  check_generate(size, NG_LINE_SOLVABLE);
+}
+
+static void setup_generate_guess(int size)
+{
+  check_generate(size, NG_NEEDS_GUESSING);
+}
+
+static void run_generate(int size, int difficulty)
+{
+  ng_layout_t layout;
+
+  if (ng_generate(size, size, difficulty, &layout, 0, GEN_BUDGET) < 0)
+    bench_fail("nonogram/generate", "budget ran out");
+  bench_sink += layout.row_runs[0];
+}
+
+static void run_generate_lines(int size)
+{
+  run_generate(size, NG_LINE_SOLVABLE);
+}
+
+static void run_generate_guess(int size)
+{
+  run_generate(size, NG_NEEDS_GUESSING);
+}
+
+const bench_t bench_nonogram[] = {
+  { "nonogram/compile",     one_size, setup_layouts, run_compile,     0 },
+  { "nonogram/clues-walk",  one_size, setup_layouts, run_clues_walk,  0 },
+  { "nonogram/clues-index", one_size, setup_layouts, run_clues_index, 0 },
+  { "nonogram/line",        one_size, 0,             run_line,        0 },
+  { "nonogram/solve",       one_size, setup_layouts, run_solve,       0 },
+  { "nonogram/validate",    one_size, setup_layouts, run_validate,    0 },
+  { "nonogram/generate-lines", gen_sizes, setup_generate_lines,
+    run_generate_lines, 0 },
+  { "nonogram/generate-guess", gen_sizes, setup_generate_guess,
+    run_generate_guess, 0 },
+  { 0 }
+};
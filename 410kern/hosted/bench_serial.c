@@ -0,0 +1,116 @@
+/** @file bench_serial.c
+ *  @brief Benchmarks for the COM1 driver's transmit ring in kern/.
+ *
+ *  The driver runs against the UART of devices.c, with the interrupt
+ *  handler called whenever the UART raises its interrupt and the FIFO
+ *  emptied between calls, as a line faster than the CPU would.  The size
+ *  is the bytes written per call, so the time covers queueing them and
+ *  every interrupt it takes to send them.
+ */
+
+#include <string.h>
+#include <serial.h>
+#include "bench.h"
+#include "devices.h"
+
+static const int byte_sizes[] = { 16, 4096, 0 };
+
+#define DATA_LEN (3 * SERIAL_TX_SIZE)
+
+static char data[DATA_LEN];
+static char expect[DATA_LEN];
+
+/* Kept by serial.c */
+extern unsigned int serial_dropped;
+
+/* Takes every interrupt the UART raises until it has nothing left to send */
+static void pump(void)
+{
+  while (uart_pending()) {
+    serial_C_handler();
+    uart_drain();
+  }
+}
+
+/* Sent on the interrupt uart_ier_hook() stands for */
+static void late_write(void)
+{
+  serial_write("late", 4);
+}
+
+/* Sends everything queued and checks it all went, in order, never
+ * overrunning the FIFO */
+static void check_sent(const char *what, const char *expect, int len)
+{
+  if (uart_nsent != len || memcmp(uart_sent, expect, len) != 0)
+    bench_fail("serial", what);
+  if (uart_overruns != 0)
+    bench_fail("serial", "transmit FIFO overrun");
+  if (serial_room() != SERIAL_TX_SIZE)
+    bench_fail("serial", "bytes left in the ring");
+}
+
+static void setup_serial(int size)
+{
+  int i, n;
+
+  for (i = 0; i < DATA_LEN; i++)
+    data[i] = 'a' + i % 23;
+
+  uart_reset();
+  if (serial_init(115200) < 0)
+    bench_fail("serial", "no UART");
+
+  /* More than the ring holds, written in pieces as it empties */
+  for (i = 0; i < DATA_LEN; i += n) {
+    n = serial_room();
+    if (n > DATA_LEN - i)
+      n = DATA_LEN - i;
+    if (n > 1000)
+      n = 1000;
+    if (serial_write(data + i, n) != n)
+      bench_fail("serial", "room reported but not there");
+    pump();
+  }
+  check_sent("sent out of order", data, DATA_LEN);
+
+  /* A full ring drops the rest, without sending anything */
+  uart_reset();
+  serial_dropped = 0;
+  if (serial_write(data, SERIAL_TX_SIZE) != SERIAL_TX_SIZE ||
+      serial_write(data, 100) != 0 || serial_dropped != 100)
+    bench_fail("serial", "full ring not counted");
+  pump();
+  check_sent("full ring sent wrongly", data, SERIAL_TX_SIZE);
+
+  /* A write from an interrupt that arrives as the handler turns the
+   * transmit interrupt off mustn't be left in the ring.  If interrupts
+   * are off there, it arrives once they're back on instead. */
+  uart_reset();
+  uart_ier_hook = late_write;
+  serial_write(data, 20);
+  pump();
+  if (uart_ier_hook) {
+    uart_ier_hook = 0;
+    late_write();
+    pump();
+  }
+  memcpy(expect, data, 20);
+  memcpy(expect + 20, "late", 4);
+  check_sent("late write stuck", expect, 24);
+
+  uart_reset();
+}
+
+static void run_write(int size)
+{
+  serial_write(data, size);
+  pump();
+  bench_sink += uart_nsent;
+  uart_nsent = 0;
+}
+
+const bench_t bench_serial[] = {
+  { "serial/write", byte_sizes, setup_serial, run_write, 0 },
+  { 0 }
+};
@@ -0,0 +1,174 @@
+/** @file bench_sokoban.c
+ *  @brief Benchmarks for the sokoban board and solver in 410kern/misc.
+ *
+ *  The size is the level number.  Every level is solved in a 1MB pool;
+ *  every solution is played back through the board and must win, and those
+ *  of levels 1-5 must take the fewest pushes.  Level 6 has too many rocks
+ *  to search for the fewest.
+ */
+
+#include <sokoban.h>
+#include <sokoban_solver.h>
+#include <sokoban_board.h>
+#include <string.h>
+#include "bench.h"
+
+static const int levels[] = { 1, 2, 3, 4, 5, 6, 0 };
+
+/* Fewest pushes that solve each level, or 0 if unknown */
+static const int optimal[] = { 8, 31, 97, 27, 131, 0 };
+
+#define POOL_SIZE (1 << 20)
+
+static unsigned int pool[POOL_SIZE / sizeof(unsigned int)];
+static soko_push_t pushes[512];
+
+static const int dir_dx[4] = { 0, 1, 0, -1 };
+static const int dir_dy[4] = { -1, 0, 1, 0 };
+
+/* Walks the pusher to (x, y) by the board's own moves, without pushing.
+ * Returns 0, or -1 if it can't get there. */
+static int walk_to(soko_board_t *b, int x, int y)
+{
+  static short came[SOKO_BOARD_HEIGHT * SOKO_BOARD_WIDTH];
+  static short queue[SOKO_BOARD_HEIGHT * SOKO_BOARD_WIDTH];
+  static unsigned char path[SOKO_BOARD_HEIGHT * SOKO_BOARD_WIDTH];
+  int head = 0, tail = 0, at, d, nx, ny, n;
+
+  for (at = 0; at < SOKO_BOARD_HEIGHT * SOKO_BOARD_WIDTH; at++)
+    came[at] = -1;
+  came[b->player] = 4;
+  queue[tail++] = b->player;
+  while (head < tail && came[SOKO_PACK(x, y)] < 0) {
+    at = queue[head++];
+    for (d = 0; d < 4; d++) {
+      nx = SOKO_X(at) + dir_dx[d];
+      ny = SOKO_Y(at) + dir_dy[d];
+      if (nx < 0 || ny < 0 || nx >= b->width || ny >= b->height ||
+          SOKO_AT(b->wall, nx, ny) || SOKO_AT(b->rock, nx, ny) ||
+          came[SOKO_PACK(nx, ny)] >= 0)
+        continue;
+      came[SOKO_PACK(nx, ny)] = d;
+      queue[tail++] = SOKO_PACK(nx, ny);
+    }
+  }
+  if (came[SOKO_PACK(x, y)] < 0)
+    return -1;
+
+  for (n = 0, at = SOKO_PACK(x, y); came[at] != 4; n++) {
+    d = came[at];
+    path[n] = d;
+    at = SOKO_PACK(SOKO_X(at) - dir_dx[d], SOKO_Y(at) - dir_dy[d]);
+  }
+  while (n > 0)
+    if (soko_board_move(b, path[--n]) & SOKO_MOVE_PUSHED)
+      return -1;
+  return 0;
+}
+
+/* Plays n pushes back on the level through the board, and checks they win */
+static void replay(const sokolevel_t *level, int n)
+{
+  soko_board_t b;
+  int i, x, y, d;
+
+  if (soko_board_init(&b, level) < 0)
+    bench_fail("sokoban/solve", "level rejected");
+  for (i = 0; i < n; i++) {
+    x = pushes[i].x;
+    y = pushes[i].y;
+    d = pushes[i].dir;
+    if (!SOKO_AT(b.rock, x, y) ||
+        walk_to(&b, x - dir_dx[d], y - dir_dy[d]) < 0 ||
+        soko_board_move(&b, d) != (d | SOKO_MOVE_PUSHED))
+      bench_fail("sokoban/solve", "solution makes an impossible push");
+  }
+  if (!SOKO_BOARD_WON(&b))
+    bench_fail("sokoban/solve", "solution doesn't win");
+}
+
+static void setup_level(int size)
+{
+  int n = soko_solve(soko_levels[size - 1], pool, sizeof(pool), pushes,
+                     sizeof(pushes) / sizeof(pushes[0]));
+
+  if (n < 0)
+    bench_fail("sokoban/solve", "no solution found");
+  if (n > sizeof(pushes) / sizeof(pushes[0]))
+    bench_fail("sokoban/solve", "solution too long to check");
+  if (optimal[size - 1] != 0 && n != optimal[size - 1])
+    bench_fail("sokoban/solve", "solution isn't push-optimal");
+  replay(soko_levels[size - 1], n);
+}
+
+static void run_solve(int size)
+{
+  bench_sink += soko_solve(soko_levels[size - 1], pool, sizeof(pool), pushes,
+                           sizeof(pushes) / sizeof(pushes[0]));
+}
+
+/* The first push only, as a hint */
+static void run_hint(int size)
+{
+  bench_sink += soko_solve(soko_levels[size - 1], pool, sizeof(pool), pushes,
+                           1);
+}
+
+static soko_board_t start, board;
+
+/* A wander around the start of each level, pushing whatever is in the way */
+static const unsigned char wander[] = {
+  SOKO_UP, SOKO_LEFT, SOKO_DOWN, SOKO_DOWN, SOKO_RIGHT, SOKO_RIGHT,
+  SOKO_UP, SOKO_UP, SOKO_UP, SOKO_LEFT, SOKO_LEFT, SOKO_LEFT,
+  SOKO_DOWN, SOKO_DOWN, SOKO_DOWN, SOKO_DOWN, SOKO_RIGHT, SOKO_UP,
+  SOKO_RIGHT, SOKO_RIGHT, SOKO_DOWN, SOKO_LEFT, SOKO_UP, SOKO_UP,
+};
+
+#define WANDER_LEN (sizeof(wander) / sizeof(wander[0]))
+
+static int moves[WANDER_LEN];
+
+static void setup_board(int size)
+{
+  int i, n = 0;
+
+  if (soko_board_init(&start, soko_levels[size - 1]) < 0)
+    bench_fail("sokoban/move", "level rejected");
+  board = start;
+  for (i = 0; i < WANDER_LEN; i++)
+    if ((moves[n] = soko_board_move(&board, wander[i])) >= 0)
+      n++;
+  while (n > 0)
+    soko_board_undo(&board, moves[--n]);
+  if (memcmp(&board, &start, sizeof(board)) != 0)
+    bench_fail("sokoban/move", "undo didn't restore the level");
+}
+
+/* Makes each move, checking for a win after it as a game would, then
+ * takes them all back */
+static void run_move(int size)
+{
+  int i, n = 0, won = 0;
+
+  for (i = 0; i < WANDER_LEN; i++) {
+    if ((moves[n] = soko_board_move(&board, wander[i])) >= 0)
+      n++;
+    won += SOKO_BOARD_WON(&board);
+  }
+  while (n > 0)
+    soko_board_undo(&board, moves[--n]);
+  bench_sink += won;
+}
+
+static void run_board_init(int size)
+{
+  bench_sink += soko_board_init(&board, soko_levels[size - 1]);
+}
+
+const bench_t bench_sokoban[] = {
+  { "sokoban/board-init", levels, 0,           run_board_init, 0 },
+  { "sokoban/move",       levels, setup_board, run_move,       0 },
+  { "sokoban/solve",      levels, setup_level, run_solve,      0 },
+  { "sokoban/hint",       levels, setup_level, run_hint,       0 },
+  { 0 }
+};
@@ -0,0 +1,214 @@
+/** @file bench_sudoku.c
+ *  @brief Benchmarks for the sudoku solvers in 410kern/misc.
+ *
+ *  Each call solves the first 'size' puzzles of sudokudb, so the time is per
+ *  pass over the database rather than per puzzle.  The generator benchmark
+ *  is the exception: its size is one more than the difficulty generated, and
+ *  each call makes one puzzle.
+ */
+
+#include <string.h>
+#include <sudoku.h>
+#include <sudokudb.h>
+#include <semisolver.h>
+#include <masksolver.h>
+#include <searchsolver.h>
+#include <sudokupack.h>
+#include <sudokugen.h>
+#include <mt19937int.h>
+#include "bench.h"
+
+static const int db_sizes[] = { MAX_SUDOKUS, 0 };
+
+/*
+ * Difficulties 0-4 take a few ms per puzzle, 5-7 tens to hundreds of ms and
+ * 8 over a second.  Difficulty 9 isn't benched: it takes seconds, and
+ * GEN_BUDGET runs out on some of its puzzles.
+ */
+static const int gen_sizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0 };
+
+#define GEN_BUDGET 100000
+
+static sudoku_t puzzles[MAX_SUDOKUS];
+static sudoku_t work[MAX_SUDOKUS];
+static int difficulty[MAX_SUDOKUS];
+static int npuzzles;
+
+/* Nonzero if s is a completed grid which agrees with the givens in 'given' */
+static int valid_solution(sudoku_t given, sudoku_t s)
+{
+  int i, j;
+  unsigned int rows[SU_GRID_SIZE] = { 0 }, cols[SU_GRID_SIZE] = { 0 };
+  unsigned int boxes[SU_GRID_SIZE] = { 0 };
+
+  for (i = 0; i < SU_GRID_SIZE; i++) {
+    for (j = 0; j < SU_GRID_SIZE; j++) {
+      int box = i / SU_BOX_SIZE * SU_BOX_SIZE + j / SU_BOX_SIZE;
+      unsigned int bit = 1 << s[i][j];
+
+      if (s[i][j] < 1 || s[i][j] > SU_GRID_SIZE)
+        return 0;
+      if (given[i][j] && given[i][j] != s[i][j])
+        return 0;
+      if ((rows[i] | cols[j] | boxes[box]) & bit)
+        return 0;
+      rows[i] |= bit;
+      cols[j] |= bit;
+      boxes[box] |= bit;
+    }
+  }
+  return 1;
+}
+
+/*
+ * Parses sudokudb, then checks once that every grid the solvers claim to
+ * solve is valid, that masksolve() finishes everything semisolve() does,
+ * that searchsolve() finishes everything and that the packed database holds
+ * the same puzzles.
+ */
+static void load_db(void)
+{
+  const char *p = sudokudb;
+  int i, semi_ok, mask_ok, seen[MAX_DIFFICULTY] = { 0 };
+  sudoku_t s;
+
+  for (npuzzles = 0; *p && npuzzles < MAX_SUDOKUS; npuzzles++) {
+    difficulty[npuzzles] = *p++ - '0';
+    for (i = 0; i < SU_GRID_AREA; i++, p++)
+      puzzles[npuzzles][i / SU_GRID_SIZE][i % SU_GRID_SIZE] =
+        *p == ' ' ? 0 : *p - '0';
+  }
+  if (npuzzles != MAX_SUDOKUS)
+    bench_fail("sudoku", "short database");
+
+  for (i = 0; i < npuzzles; i++) {
+    memcpy(s, puzzles[i], sizeof(s));
+    semi_ok = semisolve(s);
+    if (semi_ok && !valid_solution(puzzles[i], s))
+      bench_fail("sudoku/semisolve", "invalid solution");
+
+    memcpy(s, puzzles[i], sizeof(s));
+    mask_ok = masksolve(s);
+    if (mask_ok && !valid_solution(puzzles[i], s))
+      bench_fail("sudoku/masksolve", "invalid solution");
+    if (semi_ok && !mask_ok)
+      bench_fail("sudoku/masksolve", "gave up on a puzzle semisolve solves");
+
+    memcpy(s, puzzles[i], sizeof(s));
+    if (!searchsolve(s) || !valid_solution(puzzles[i], s))
+      bench_fail("sudoku/searchsolve", "no valid solution");
+
+    if (sudoku_get(difficulty[i], seen[difficulty[i]]++, s) < 0 ||
+        memcmp(s, puzzles[i], sizeof(s)))
+      bench_fail("sudoku/get", "packed puzzle differs from the text");
+  }
+  for (i = 0; i < MAX_DIFFICULTY; i++)
+    if (sudoku_count(i) != seen[i])
+      bench_fail("sudoku/get", "wrong bucket size");
+}
+
+/* The solvers work in place, so these run with per_call_setup */
+static void setup_db(int size)
+{
+  if (npuzzles == 0)
+    load_db();
+  memcpy(work, puzzles, size * sizeof(sudoku_t));
+}
+
+static void run_semisolve(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    bench_sink += semisolve(work[i]);
+}
+
+static void run_masksolve(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    bench_sink += masksolve(work[i]);
+}
+
+static void run_searchsolve(int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    bench_sink += searchsolve(work[i]);
+}
+
+static void run_rate(int size)
+{
+  int i;
+  su_effort_t effort;
+
+  for (i = 0; i < size; i++)
+    bench_sink += su_rate(work[i], &effort) + su_difficulty(&effort);
+}
+
+/* Fetches puzzle n of each difficulty in turn, for n < size / MAX_DIFFICULTY */
+static void run_get(int size)
+{
+  int d, n;
+
+  for (n = 0; n < size / MAX_DIFFICULTY; n++)
+    for (d = 0; d < MAX_DIFFICULTY; d++)
+      if (sudoku_get(d, n % sudoku_count(d), work[0]) == 0)
+        bench_sink += work[0][4][4];
+}
+
+/* The same accesses, finding each puzzle by parsing sudokudb from the start */
+static void run_text_scan(int size)
+{
+  int d, n, i, skip;
+  const char *p;
+
+  for (n = 0; n < size / MAX_DIFFICULTY; n++) {
+    for (d = 0; d < MAX_DIFFICULTY; d++) {
+      skip = n % sudoku_count(d);
+      for (p = sudokudb; *p; p += 1 + SU_GRID_AREA)
+        if (*p == '0' + d && skip-- == 0)
+          break;
+      for (i = 0; i < SU_GRID_AREA; i++)
+        work[0][i / SU_GRID_SIZE][i % SU_GRID_SIZE] =
+          p[1 + i] == ' ' ? 0 : p[1 + i] - '0';
+      bench_sink += work[0][4][4];
+    }
+  }
+}
+
+static void setup_generate(int size)
+{
+  sudoku_t puzzle;
+  su_effort_t effort;
+
+  sgenrand(4357);
+  if (su_generate(puzzle, size - 1, GEN_BUDGET) < 0)
+    bench_fail("sudoku/generate", "budget ran out");
+  if (su_rate(puzzle, &effort) != 1)
+    bench_fail("sudoku/generate", "puzzle isn't unique");
+  if (su_difficulty(&effort) != size - 1)
+    bench_fail("sudoku/generate", "wrong difficulty");
+}
+
+static void run_generate(int size)
+{
+  sudoku_t puzzle;
+
+  if (su_generate(puzzle, size - 1, GEN_BUDGET) < 0)
+    bench_fail("sudoku/generate", "budget ran out");
+  bench_sink += puzzle[0][0];
+}
+
+const bench_t bench_sudoku[] = {
+  { "sudoku/semisolve",   db_sizes, setup_db, run_semisolve,   1 },
+  { "sudoku/masksolve",   db_sizes, setup_db, run_masksolve,   1 },
+  { "sudoku/searchsolve", db_sizes, setup_db, run_searchsolve, 1 },
+  { "sudoku/rate",        db_sizes, setup_db, run_rate,        1 },
+  { "sudoku/get",         db_sizes, setup_db, run_get,         0 },
+  { "sudoku/text-scan",   db_sizes, setup_db, run_text_scan,   0 },
+  { "sudoku/generate",    gen_sizes, setup_generate, run_generate, 0 },
+  { 0 }
+};
@@ -0,0 +1,125 @@
+/** @file bench_texttwist.c
+ *  @brief Benchmarks for the texttwist dictionary index and word graph in
+ *  410kern/misc.
+ */
+
+#include <string.h>
+#include <texttwist_dict.h>
+#include <texttwist_index.h>
+#include <texttwist_dawg.h>
+#include "bench.h"
+
+static const int one_size[] = { 1, 0 };
+
+static const char rack[] = "listen";
+
+/* Words in "listen", found by scanning the dictionary */
+#define RACK_WORDS 66
+
+static tt_word_t words[128];
+
+static void setup_index(int size)
+{
+  if (tt_index_init() < 0)
+    bench_fail("texttwist/init", "dictionary rejected");
+  if (tt_subwords(rack, words, 128) != RACK_WORDS)
+    bench_fail("texttwist/subwords-index", "wrong number of words");
+  if (!tt_is_word("tinsel") || tt_is_word("tinsle"))
+    bench_fail("texttwist/is-word", "wrong answer");
+}
+
+static char dawg_words[128][TT_MAX_WORD + 1];
+
+static void setup_dawg(int size)
+{
+  int i, n;
+
+  setup_index(size);
+  n = tt_dawg_rack_words(rack, dawg_words, 128);
+  if (n != RACK_WORDS)
+    bench_fail("texttwist/dawg-rack", "wrong number of words");
+  for (i = 0; i < n; i++)
+    if (!tt_is_word(dawg_words[i]))
+      bench_fail("texttwist/dawg-rack", "found a non-word");
+  if (!tt_dawg_is_word("tinsel") || tt_dawg_is_word("tinsle") ||
+      !tt_dawg_is_prefix("tins") || tt_dawg_is_prefix("tinsl"))
+    bench_fail("texttwist/dawg-is-word", "wrong answer");
+}
+
+static void run_init(int size)
+{
+  bench_sink += tt_index_init();
+}
+
+/* What a game does without the index: checks every word's letters
+ * against the rack's */
+static void run_subwords_scan(int size)
+{
+  int counts[26], used[26];
+  const char *p, *w;
+  int found = 0;
+
+  memset(counts, 0, sizeof(counts));
+  for (p = rack; *p != '\0'; p++)
+    counts[*p - 'a']++;
+
+  for (p = texttwist_dict; *p != '\0'; p++) {
+    if (*p == ' ')
+      continue;
+    memset(used, 0, sizeof(used));
+    for (w = p; *p != ' ' && *p != '\0'; p++)
+      if (++used[*p - 'a'] > counts[*p - 'a'])
+        break;
+    if (*p == ' ' || *p == '\0') {
+      if (found < 128) {
+        words[found].text = w;
+        words[found].len = p - w;
+      }
+      found++;
+    } else {
+      while (*p != ' ' && *p != '\0')
+        p++;
+    }
+    if (*p == '\0')
+      break;
+  }
+  if (found != RACK_WORDS)
+    bench_fail("texttwist/subwords-scan", "wrong number of words");
+  bench_sink += found;
+}
+
+static void run_subwords_index(int size)
+{
+  bench_sink += tt_subwords(rack, words, 128);
+}
+
+static void run_is_word(int size)
+{
+  bench_sink += tt_is_word("tinsel") + tt_is_word("tinsle");
+}
+
+static void run_dawg_rack(int size)
+{
+  bench_sink += tt_dawg_rack_words(rack, dawg_words, 128);
+}
+
+static void run_dawg_is_word(int size)
+{
+  bench_sink += tt_dawg_is_word("tinsel") + tt_dawg_is_word("tinsle");
+}
+
+static void run_dawg_prefix(int size)
+{
+  bench_sink += tt_dawg_is_prefix("tins") + tt_dawg_is_prefix("tinsl");
+}
+
+const bench_t bench_texttwist[] = {
+  { "texttwist/init",           one_size, 0,           run_init,           0 },
+  { "texttwist/subwords-scan",  one_size, 0,           run_subwords_scan,  0 },
+  { "texttwist/subwords-index", one_size, setup_index, run_subwords_index, 0 },
+  { "texttwist/is-word",        one_size, setup_index, run_is_word,        0 },
+  { "texttwist/dawg-rack",      one_size, setup_dawg,  run_dawg_rack,      0 },
+  { "texttwist/dawg-is-word",   one_size, setup_dawg,  run_dawg_is_word,   0 },
+  { "texttwist/dawg-prefix",    one_size, setup_dawg,  run_dawg_prefix,    0 },
+  { 0 }
+};
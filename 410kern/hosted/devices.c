@@ -0,0 +1,155 @@
+/** @file devices.c
+ *  @brief Port I/O for the hosted build, standing in for the devices the
+ *         drivers in kern/ talk to.
+ *
+ *  The VGA CRTC's index and data ports keep a register file, so the
+ *  cursor and display start registers read back what was written.  Text
+ *  memory itself is ordinary memory mapped by hosted_map().
+ *
+ *  COM1 is a 16550 as far as the transmit side goes: bytes written to it
+ *  go into a 16-byte FIFO, which empties only when uart_drain() says so,
+ *  and the transmit interrupt is raised as the chip raises it.  What was
+ *  sent is kept for the caller to check.  Received bytes never arrive.
+ *
+ *  Ports with nothing behind them ignore writes and read as 0xFF, as on a
+ *  PC.
+ */
+
+#include <stdint.h>
+#include <asm.h>
+#include <eflags.h>
+#include <video_defines.h>
+#include <serial.h>
+#include "devices.h"
+
+#define CRTC_START_MSB 0x0C
+#define CRTC_START_LSB 0x0D
+
+#define UART_LSR_THRE 0x20   /* transmit FIFO empty */
+#define UART_LSR_TEMT 0x40   /* transmitter idle */
+
+static uint8_t crtc_index;
+static uint8_t crtc_regs[256];
+
+static uint8_t uart_ier, uart_lcr, uart_scr;
+static int uart_fifo;          /* bytes in the transmit FIFO */
+static int uart_thre;          /* transmit interrupt raised and unread */
+
+unsigned char uart_sent[UART_SENT_MAX];
+unsigned int uart_nsent;
+unsigned int uart_overruns;
+void (*uart_ier_hook)(void);
+
+unsigned int crtc_start(void)
+{
+  return crtc_regs[CRTC_START_MSB] << 8 | crtc_regs[CRTC_START_LSB];
+}
+
+static void uart_write(int reg, uint8_t val)
+{
+  void (*hook)(void);
+
+  if (uart_lcr & LCR_DLAB && (reg == UART_DLL || reg == UART_DLM))
+    return;
+
+  switch (reg) {
+  case UART_DATA:
+    if (uart_fifo == UART_FIFO_SIZE)
+      uart_overruns++;
+    else {
+      uart_fifo++;
+      if (uart_nsent < UART_SENT_MAX)
+        uart_sent[uart_nsent++] = val;
+    }
+    uart_thre = 0;
+    break;
+  case UART_IER:
+    /* An interrupt arriving just before the transmit interrupt goes off */
+    hook = uart_ier_hook;
+    if (hook && !(val & IER_THRE) && (get_eflags() & EFL_IF)) {
+      uart_ier_hook = 0;
+      hook();
+    }
+    /* Enabling the interrupt with the FIFO empty raises it at once */
+    if (val & IER_THRE && !(uart_ier & IER_THRE) && uart_fifo == 0)
+      uart_thre = 1;
+    uart_ier = val;
+    break;
+  case UART_LCR:
+    uart_lcr = val;
+    break;
+  case UART_SCR:
+    uart_scr = val;
+    break;
+  }
+}
+
+static uint8_t uart_read(int reg)
+{
+  switch (reg) {
+  case UART_IIR:
+    /* Reading the identification clears the transmit interrupt */
+    if (uart_thre && uart_ier & IER_THRE) {
+      uart_thre = 0;
+      return IIR_THRE;
+    }
+    return IIR_NONE;
+  case UART_LSR:
+    return uart_fifo == 0 ? UART_LSR_THRE | UART_LSR_TEMT : 0;
+  case UART_LCR:
+    return uart_lcr;
+  case UART_SCR:
+    return uart_scr;
+  case UART_IER:
+    return uart_ier;
+  }
+  return 0;
+}
+
+int uart_pending(void)
+{
+  return uart_thre && uart_ier & IER_THRE;
+}
+
+void uart_drain(void)
+{
+  if (uart_fifo > 0) {
+    uart_fifo = 0;
+    uart_thre = 1;
+  }
+}
+
+void uart_reset(void)
+{
+  uart_ier = uart_lcr = uart_scr = 0;
+  uart_fifo = uart_thre = 0;
+  uart_nsent = uart_overruns = 0;
+  uart_ier_hook = 0;
+}
+
+void outb(uint16_t port, uint8_t val)
+{
+  if (port == CRTC_IDX_REG)
+    crtc_index = val;
+  else if (port == CRTC_DATA_REG)
+    crtc_regs[crtc_index] = val;
+  else if (port >= COM1_BASE && port <= COM1_BASE + UART_SCR)
+    uart_write(port - COM1_BASE, val);
+}
+
+uint8_t inb(uint16_t port)
+{
+  if (port == CRTC_IDX_REG)
+    return crtc_index;
+  if (port == CRTC_DATA_REG)
+    return crtc_regs[crtc_index];
+  if (port >= COM1_BASE && port <= COM1_BASE + UART_SCR)
+    return uart_read(port - COM1_BASE);
+  return 0xFF;
+}
+
+/* The keyboard's buffer, where serial input goes; there is no keyboard */
+void sbuf_insert(int item)
+{
+  (void)item;
+}
@@ -0,0 +1,34 @@
+/** @file devices.h
+ *  @brief Controls for the stand-in devices of devices.c.
+ */
+
+#ifndef _DEVICES_H_
+#define _DEVICES_H_
+
+/* How much of what's sent on COM1 is kept */
+#define UART_SENT_MAX (1 << 16)
+
+/** Bytes sent on COM1 since uart_reset(), the first UART_SENT_MAX of them */
+extern unsigned char uart_sent[UART_SENT_MAX];
+extern unsigned int uart_nsent;
+
+/** Bytes written to the transmit FIFO while it was full */
+extern unsigned int uart_overruns;
+
+/** If set, called once, as if an interrupt arrived, the next time the
+ *  transmit interrupt is turned off with interrupts enabled */
+extern void (*uart_ier_hook)(void);
+
+/** @brief The cell the CRTC starts the display at */
+unsigned int crtc_start(void);
+
+/** @brief Nonzero if COM1 is raising its interrupt */
+int uart_pending(void);
+
+/** @brief Sends everything in the transmit FIFO */
+void uart_drain(void);
+
+/** @brief Powers COM1 back up, forgetting what was sent */
+void uart_reset(void);
+
+#endif /* _DEVICES_H_ */
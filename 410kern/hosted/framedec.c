@@ -0,0 +1,97 @@
+/** @file framedec.c
+ *  @brief Decoder for frames recorded by kern/recorder.c.
+ *
+ *  Reads a recording (from a file, or stdin), plays each frame onto a
+ *  screen with framerec_apply() and prints the screen after it as 25
+ *  lines of text, non-printing characters shown as '.':
+ *
+ *    ./framedec capture.bin        # every frame
+ *    ./framedec -l capture.bin     # only the last
+ *
+ *  Like host.c, this is compiled against the host's headers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <video_defines.h>
+#include <console_cells.h>
+#include <framerec.h>
+
+static cell_t screen[CONSOLE_HEIGHT * CONSOLE_WIDTH];
+
+static unsigned char *read_all(FILE *f, long *len)
+{
+  unsigned char *buf = NULL;
+  long size = 0, n;
+
+  *len = 0;
+  do {
+    if (*len == size) {
+      size = size ? 2 * size : 65536;
+      if ((buf = realloc(buf, size)) == NULL) {
+        perror("framedec");
+        exit(1);
+      }
+    }
+    n = fread(buf + *len, 1, size - *len, f);
+    *len += n;
+  } while (n > 0);
+  return buf;
+}
+
+static void print_screen(int frame, int bytes)
+{
+  char line[CONSOLE_WIDTH + 1];
+  int row, col, ch;
+
+  printf("-- frame %d, %d bytes\n", frame, bytes);
+  for (row = 0; row < CONSOLE_HEIGHT; row++) {
+    for (col = 0; col < CONSOLE_WIDTH; col++) {
+      ch = CELL_CHAR(screen[row * CONSOLE_WIDTH + col]) & 0xFF;
+      line[col] = (ch >= ' ' && ch < 0x7F) ? ch : '.';
+    }
+    line[col] = '\0';
+    printf("%s\n", line);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  unsigned char *buf;
+  long len, pos = 0;
+  int last_only = 0, frame = 0, n, last = 0;
+  FILE *f = stdin;
+
+  if (argc > 1 && strcmp(argv[1], "-l") == 0) {
+    last_only = 1;
+    argc--;
+    argv++;
+  }
+  if (argc > 2) {
+    fprintf(stderr, "usage: framedec [-l] [recording]\n");
+    return 2;
+  }
+  if (argc == 2 && (f = fopen(argv[1], "rb")) == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+  buf = read_all(f, &len);
+
+  while (pos < len) {
+    n = framerec_apply(screen, buf + pos, len - pos);
+    if (n < 0) {
+      fprintf(stderr, "framedec: bad or cut-off frame at byte %ld\n", pos);
+      break;
+    }
+    if (!last_only)
+      print_screen(frame, n);
+    pos += n;
+    last = n;
+    frame++;
+  }
+  if (last_only && frame > 0)
+    print_screen(frame - 1, last);
+  return pos < len;
+}
@@ -0,0 +1,92 @@
+/** @file host.c
+ *  @brief Host-side stand-ins for the kernel environment.
+ *
+ *  This is the only hosted file compiled against the host's own headers.
+ *  It supplies the clock, output and memory mapping used by the benchmarks,
+ *  the simulator and interrupt-flag calls the libraries make, and routes
+ *  the 410 malloc entry points to the host allocator.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#include "hosted.h"
+
+/* Must agree with 410kern/simics/simics.h */
+#define SIM_PUTS 0x04100002
+
+/* Must agree with 410kern/x86/eflags.h */
+#define EFL_IF 0x00000200
+
+uint64_t hosted_now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void hosted_puts(const char *s)
+{
+  fputs(s, stdout);
+}
+
+void hosted_exit(int status)
+{
+  fflush(stdout);
+  exit(status);
+}
+
+void hosted_map(uintptr_t addr, unsigned long len)
+{
+  void *p = mmap((void *)addr, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+  if (p != (void *)addr) {
+    fprintf(stderr, "can't map memory at %#lx\n", (unsigned long)addr);
+    exit(1);
+  }
+}
+
+/* The simulator's magic instruction: print what would reach the console */
+int sim_call(int ebx, ...)
+{
+  va_list ap;
+
+  if (ebx == SIM_PUTS) {
+    va_start(ap, ebx);
+    printf("[sim] %s\n", va_arg(ap, const char *));
+    va_end(ap);
+  }
+  return 0;
+}
+
+/* Nothing interrupts a user process, but the interrupt flag is kept so
+ * devices.c can tell when an interrupt could have arrived */
+static uint32_t eflags = EFL_IF;
+
+uint32_t get_eflags(void) { return eflags; }
+void set_eflags(uint32_t flags) { eflags = flags; }
+void disable_interrupts(void) { eflags &= ~EFL_IF; }
+void enable_interrupts(void) { eflags |= EFL_IF; }
+
+void panic(const char *fmt, ...)
+{
+  va_list ap;
+
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fputc('\n', stderr);
+  abort();
+}
+
+void *_malloc(size_t size) { return malloc(size); }
+void *_smalloc(size_t size) { return malloc(size); }
+void *_calloc(size_t nelt, size_t eltsize) { return calloc(nelt, eltsize); }
+void *_realloc(void *buf, size_t size) { return realloc(buf, size); }
+void _free(void *buf) { free(buf); }
@@ -0,0 +1,28 @@
+/** @file hosted.h
+ *  @brief Services the host provides to the hosted build.
+ *
+ *  Everything else in the hosted build is compiled against the 410kern
+ *  headers, which cannot be mixed with the host's; this is the narrow
+ *  interface to the one file (host.c) that uses the host's headers.
+ */
+
+#ifndef _HOSTED_H_
+#define _HOSTED_H_
+
+#include <stdint.h>
+
+/** @brief Returns a monotonic timestamp in nanoseconds */
+uint64_t hosted_now_ns(void);
+
+/** @brief Writes a string to standard output, without a newline */
+void hosted_puts(const char *s);
+
+/** @brief Terminates the program with the given exit status */
+void hosted_exit(int status);
+
+/** @brief Maps len bytes of zeroed memory at addr, where the kernel would
+ *         find device memory such as the screen, or exits if it can't
+ */
+void hosted_map(uintptr_t addr, unsigned long len);
+
+#endif /* _HOSTED_H_ */
@@ -0,0 +1,29 @@
+/** @file 410kern/hosted/inc/stdint.h
+ *  @brief Fixed-size integer types for the hosted (LP64) build.
+ *
+ *  Shadows 410kern/inc/stdint.h, which spells the 32-bit types as long.
+ *  That is right for i386 but makes uint32_t 64 bits wide on x86-64,
+ *  which would silently change the arithmetic of the code under test.
+ */
+
+#ifndef LIB_STDINT_H
+#define LIB_STDINT_H
+
+#ifndef ASSEMBLER
+
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t;
+typedef unsigned long long uint64_t;
+
+typedef signed char int8_t;
+typedef signed short int16_t;
+typedef signed int int32_t;
+typedef signed long long int64_t;
+
+typedef long intptr_t;
+typedef unsigned long uintptr_t;
+
+#endif /* !ASSEMBLER */
+
+#endif /* !LIB_STDINT_H */
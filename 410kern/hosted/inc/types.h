@@ -0,0 +1,24 @@
+/** @file 410kern/hosted/inc/types.h
+ *  @brief Basic types for the hosted (LP64) build.
+ *
+ *  Shadows 410kern/inc/types.h so that size_t has the width the host C
+ *  library expects when the code under test calls into it.
+ */
+
+#ifndef LIB_TYPES_H
+#define LIB_TYPES_H
+
+typedef unsigned long size_t;
+typedef long ptrdiff_t;
+
+/* WRAPPERS */
+
+typedef unsigned long vm_offset_t;
+typedef unsigned long vm_size_t;
+
+typedef enum {
+    FALSE = 0,
+    TRUE
+} boolean_t;
+
+#endif /* !LIB_TYPES_H */
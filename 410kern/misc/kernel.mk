@@ -7,3 +7,28 @@ ALL_410KOBJS += $(410K_MISC_OBJS)
 410KCLEANS += $(410KDIR)/libmisc.a
 
 $(410KDIR)/libmisc.a: $(410K_MISC_OBJS)
+
+# The packed sudoku database (sudokupack.h) is generated from the text one
+# by a host program, so it always matches sudokudb.c.
+HOSTCC ?= gcc
+
+410KCLEANS += $(410KDIR)/misc/sudokudb_pack $(410KDIR)/misc/sudokudb_packed.c
+
+$(410KDIR)/misc/sudokudb_pack: $(410KDIR)/misc/sudokudb_pack.c \
+		$(410KDIR)/misc/sudokudb.c $(410KDIR)/misc/sudokudb.h \
+		$(410KDIR)/misc/sudokupack.h $(410KDIR)/misc/sudoku.h
+	$(HOSTCC) -o $@ $(filter %.c,$^)
+
+$(410KDIR)/misc/sudokudb_packed.c: $(410KDIR)/misc/sudokudb_pack
+	$< > $@ || (rm -f $@; false)
+
+# Likewise the texttwist word graph (texttwist_dawg.h) from the dictionary
+410KCLEANS += $(410KDIR)/misc/texttwist_pack $(410KDIR)/misc/texttwist_packed.c
+
+$(410KDIR)/misc/texttwist_pack: $(410KDIR)/misc/texttwist_pack.c \
+		$(410KDIR)/misc/texttwist_dict.c $(410KDIR)/misc/texttwist_dict.h \
+		$(410KDIR)/misc/texttwist_dawg.h
+	$(HOSTCC) -o $@ $(filter %.c,$^)
+
+$(410KDIR)/misc/texttwist_packed.c: $(410KDIR)/misc/texttwist_pack
+	$< > $@ || (rm -f $@; false)
@@ -0,0 +1,209 @@
+/**
+ * @brief A bitmask candidate-set sudoku engine
+ *
+ * Where the semisolver rescans a 9x9x9 table of possibilities on every pass,
+ * this engine keeps only which digits are used in each unit (row, column or
+ * box), from which the candidates of any cell are a couple of ORs away. Two
+ * rules are applied:
+ *
+ *  - naked single: a blank cell with exactly one candidate gets that digit
+ *  - hidden single: a digit which fits in exactly one cell of a unit goes
+ *    there
+ *
+ * Rather than sweeping the whole grid until nothing changes, placements
+ * record which units they could have affected, and only those are visited.
+ * Placing d at (row, col) changes the candidates of the cells in the three
+ * units through (row, col), so those are rescanned in full. It also removes d
+ * from cells in every column, every row and the boxes sharing a band or stack
+ * with (row, col), so those units are rechecked for d as a hidden single only.
+ */
+
+#include "masksolver.h"
+
+/* Cell indices (row * SU_GRID_SIZE + col) of the cells of each unit */
+static unsigned char unit_cells[SU_NUM_UNITS][SU_GRID_SIZE];
+static int unit_cells_ready;
+
+static void init_unit_cells(void) {
+  int u, i;
+
+  for (u = 0; u < SU_GRID_SIZE; u++) {
+    for (i = 0; i < SU_GRID_SIZE; i++) {
+      int box_row = u / SU_BOX_SIZE * SU_BOX_SIZE + i / SU_BOX_SIZE;
+      int box_col = u % SU_BOX_SIZE * SU_BOX_SIZE + i % SU_BOX_SIZE;
+      unit_cells[u][i] = u * SU_GRID_SIZE + i;
+      unit_cells[SU_GRID_SIZE + u][i] = i * SU_GRID_SIZE + u;
+      unit_cells[2 * SU_GRID_SIZE + u][i] = box_row * SU_GRID_SIZE + box_col;
+    }
+  }
+  unit_cells_ready = 1;
+}
+
+/* Adds work for unit 'unit' to the worklist */
+static void mark(su_masks_t *m, int unit, unsigned int work) {
+  m->pending[unit] |= work;
+  m->queued |= 1 << unit;
+}
+
+/**
+ * @brief Places 'num' at (row, col) and queues the units it affects
+ *
+ * It is assumed that (row, col) is blank and that 'num' is one of its
+ * candidates.
+ */
+void su_place(su_masks_t *m, int row, int col, int num) {
+  int i;
+  int box = row / SU_BOX_SIZE * SU_BOX_SIZE + col / SU_BOX_SIZE;
+  unsigned int bit = 1 << (num - 1);
+
+  m->grid[row][col] = num;
+  m->used[row] |= bit;
+  m->used[SU_GRID_SIZE + col] |= bit;
+  m->used[2 * SU_GRID_SIZE + box] |= bit;
+  m->empty--;
+
+  for (i = 0; i < SU_GRID_SIZE; i++) {
+    mark(m, i, bit);
+    mark(m, SU_GRID_SIZE + i, bit);
+  }
+  for (i = 0; i < SU_BOX_SIZE; i++) {
+    mark(m, 2 * SU_GRID_SIZE + box / SU_BOX_SIZE * SU_BOX_SIZE + i, bit);
+    mark(m, 2 * SU_GRID_SIZE + box % SU_BOX_SIZE + i * SU_BOX_SIZE, bit);
+  }
+  mark(m, row, SU_ALL_DIGITS | SU_CHECK_CELLS);
+  mark(m, SU_GRID_SIZE + col, SU_ALL_DIGITS | SU_CHECK_CELLS);
+  mark(m, 2 * SU_GRID_SIZE + box, SU_ALL_DIGITS | SU_CHECK_CELLS);
+}
+
+/**
+ * @brief Sets up the candidate masks for a sudoku
+ *
+ * @return 0 on success, or -1 if two of the given numbers conflict
+ */
+int su_masks_init(su_masks_t *m, sudoku_t sudoku) {
+  int row, col, u;
+
+  if (!unit_cells_ready)
+    init_unit_cells();
+
+  for (u = 0; u < SU_NUM_UNITS; u++) {
+    m->used[u] = 0;
+    m->pending[u] = 0;
+  }
+  m->queued = 0;
+  m->empty = SU_GRID_AREA;
+
+  for (row = 0; row < SU_GRID_SIZE; row++) {
+    for (col = 0; col < SU_GRID_SIZE; col++) {
+      int num = sudoku[row][col];
+      m->grid[row][col] = 0;
+      if (num == 0)
+        continue;
+      if (num < 0 || num > SU_GRID_SIZE ||
+          !(su_candidates(m, row, col) & (1 << (num - 1))))
+        return -1;
+      su_place(m, row, col, num);
+    }
+  }
+  return 0;
+}
+
+/* Returns the digit (1-9) of a single-bit candidate mask */
+static int mask_digit(unsigned int mask) {
+  return __builtin_ctz(mask) + 1;
+}
+
+/**
+ * @brief Examines one unit, making at most one placement
+ *
+ * @return 1 if something was placed, 0 if not, or SU_CONTRADICTION if the
+ *         unit can no longer be completed
+ */
+static int visit(su_masks_t *m, int unit, su_stats_t *stats) {
+  int i;
+  unsigned int work = m->pending[unit];
+  unsigned int once = 0, twice = 0, hidden;
+
+  m->pending[unit] = 0;
+  m->queued &= ~(1 << unit);
+
+  for (i = 0; i < SU_GRID_SIZE; i++) {
+    int cell = unit_cells[unit][i];
+    int row = cell / SU_GRID_SIZE, col = cell % SU_GRID_SIZE;
+    unsigned int cand;
+
+    if (m->grid[row][col] != 0)
+      continue;
+    cand = su_candidates(m, row, col);
+    if (cand == 0)
+      return SU_CONTRADICTION;
+    if ((work & SU_CHECK_CELLS) && (cand & (cand - 1)) == 0) {
+      su_place(m, row, col, mask_digit(cand));
+      if (stats)
+        stats->naked++;
+      return 1;
+    }
+    twice |= once & cand;
+    once |= cand;
+  }
+
+  /* Every digit not yet in the unit needs somewhere to go */
+  if ((once | m->used[unit]) != SU_ALL_DIGITS)
+    return SU_CONTRADICTION;
+
+  hidden = once & ~twice & work & SU_ALL_DIGITS;
+  if (hidden == 0)
+    return 0;
+  hidden &= -hidden;
+  for (i = 0; i < SU_GRID_SIZE; i++) {
+    int cell = unit_cells[unit][i];
+    int row = cell / SU_GRID_SIZE, col = cell % SU_GRID_SIZE;
+    if (m->grid[row][col] == 0 && (su_candidates(m, row, col) & hidden)) {
+      su_place(m, row, col, mask_digit(hidden));
+      if (stats)
+        stats->hidden++;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Applies naked and hidden singles until the worklist runs dry
+ *
+ * 'stats' may be NULL; otherwise the deductions made are added to it.
+ *
+ * @return SU_SOLVED if the grid was completed, SU_CONTRADICTION if it can't
+ *         be, or SU_STUCK if neither rule applies anywhere
+ */
+int su_propagate(su_masks_t *m, su_stats_t *stats) {
+  while (m->queued != 0) {
+    if (visit(m, __builtin_ctz(m->queued), stats) == SU_CONTRADICTION)
+      return SU_CONTRADICTION;
+  }
+  return m->empty == 0 ? SU_SOLVED : SU_STUCK;
+}
+
+/**
+ * @brief Attempts to solve the given sudoku in place.
+ *
+ * Like semisolve(), everything that could be deduced is filled in even when
+ * the sudoku isn't finished. A sudoku with no solution is left untouched.
+ *
+ * @return 1 if the sudoku has been solved, or 0 if it has not been solved
+ */
+int masksolve(sudoku_t sudoku) {
+  int row, col, result;
+  su_masks_t m;
+
+  if (su_masks_init(&m, sudoku) < 0)
+    return 0;
+  result = su_propagate(&m, 0);
+  if (result == SU_CONTRADICTION)
+    return 0;
+
+  for (row = 0; row < SU_GRID_SIZE; row++)
+    for (col = 0; col < SU_GRID_SIZE; col++)
+      sudoku[row][col] = m.grid[row][col];
+  return result == SU_SOLVED;
+}
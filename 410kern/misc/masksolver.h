@@ -0,0 +1,70 @@
+/**
+ * @file masksolver.h
+ * @brief Headers for the bitmask candidate-set sudoku engine
+ *
+ * The state of a puzzle is kept as one 9-bit mask per row, column and box of
+ * the digits already placed in it (bit k set means k + 1 is used), so the
+ * candidates of a cell are just the complement of three OR'd masks.
+ */
+
+#ifndef _MASKSOLVER_H
+#define _MASKSOLVER_H
+
+#include "sudoku.h"
+
+/* Mask with one bit for each digit */
+#define SU_ALL_DIGITS ((1 << SU_GRID_SIZE) - 1)
+
+/* Flag in su_masks_t.pending asking for a naked single scan of a unit */
+#define SU_CHECK_CELLS (1 << SU_GRID_SIZE)
+
+/* Units (rows, then columns, then boxes) which constrain a grid */
+#define SU_NUM_UNITS (3 * SU_GRID_SIZE)
+
+/* Results of su_propagate() */
+#define SU_CONTRADICTION (-1)
+#define SU_STUCK 0
+#define SU_SOLVED 1
+
+typedef struct su_masks {
+  sudoku_t grid;
+  /* Digits placed in each unit: rows 0-8, columns 9-17, boxes 18-26 */
+  unsigned short used[SU_NUM_UNITS];
+  /*
+   * Work left for each unit: the digits which may have become hidden singles
+   * there, plus SU_CHECK_CELLS if its cells may have become naked singles.
+   * 'queued' has bit u set iff pending[u] is nonzero.
+   */
+  unsigned short pending[SU_NUM_UNITS];
+  unsigned int queued;
+  /* Number of blank cells in 'grid' */
+  int empty;
+} su_masks_t;
+
+/* Counts of the deductions su_propagate() made */
+typedef struct su_stats {
+  unsigned int naked;
+  unsigned int hidden;
+} su_stats_t;
+
+/* Number of digits in a candidate mask */
+static inline int su_count(unsigned int mask) {
+  mask = mask - ((mask >> 1) & 0x5555);
+  mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+  mask = (mask + (mask >> 4)) & 0x0f0f;
+  return (mask + (mask >> 8)) & 0x1f;
+}
+
+/* Candidate digits for the blank cell at (row, col) */
+static inline unsigned int su_candidates(su_masks_t *m, int row, int col) {
+  int box = row / SU_BOX_SIZE * SU_BOX_SIZE + col / SU_BOX_SIZE;
+  return SU_ALL_DIGITS & ~(m->used[row] | m->used[SU_GRID_SIZE + col] |
+                           m->used[2 * SU_GRID_SIZE + box]);
+}
+
+int su_masks_init(su_masks_t *m, sudoku_t sudoku);
+void su_place(su_masks_t *m, int row, int col, int num);
+int su_propagate(su_masks_t *m, su_stats_t *stats);
+int masksolve(sudoku_t sudoku);
+
+#endif /* _MASKSOLVER_H */
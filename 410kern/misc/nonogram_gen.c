@@ -0,0 +1,118 @@
+/**
+ * @file nonogram_gen.c
+ * @brief Generates random Nonogram layouts with one solution
+ *
+ * A random picture is drawn, its clues are read off, and the solver checks
+ * that the clues lead back to that picture and no other. Random pictures
+ * have about 60% of their cells filled, which makes unique clues likely
+ * without making every line trivial. Pictures that fail are thrown away.
+ *
+ * The caller bounds the number of pictures tried, so generation takes
+ * bounded time. The random numbers come from genrand(), so the caller
+ * seeds it.
+ */
+
+#include <mt19937int.h>
+#include "nonogram_gen.h"
+
+/** Chance, in 256ths, that a cell of a random picture is filled */
+#define FILL_CHANCE 154
+
+/** @brief Draws a random picture of rows x cols cells */
+static void random_picture(int rows, int cols, ng_line_t *picture) {
+  unsigned long bits = 0;
+  int r, c, left = 0;
+
+  for (r = 0; r < rows; r++) {
+    picture[r] = 0;
+    for (c = 0; c < cols; c++) {
+      if (left == 0) {
+        bits = genrand();
+        left = 4;
+      }
+      if ((bits & 0xff) < FILL_CHANCE)
+        picture[r] |= 1u << c;
+      bits >>= 8;
+      left--;
+    }
+  }
+}
+
+/**
+ * @brief Appends the runs of a line of a picture to a run array
+ *
+ * @return the index in runs after the line's NG_RUN_END
+ */
+static int add_runs(const ng_line_t *picture, int line, int is_col, int len,
+                    int *runs, int pos) {
+  int i, run = 0;
+
+  for (i = 0; i <= len; i++) {
+    int filled = i < len && (is_col ? (picture[i] >> line) & 1
+                                    : (picture[line] >> i) & 1);
+    if (filled) {
+      run++;
+    } else if (run > 0) {
+      runs[pos++] = run;
+      run = 0;
+    }
+  }
+  runs[pos++] = NG_RUN_END;
+  return pos;
+}
+
+/** @brief Reads a layout's clues off a picture */
+static void picture_clues(int rows, int cols, const ng_line_t *picture,
+                          ng_layout_t *layout) {
+  int line, pos;
+
+  layout->rows = rows;
+  layout->cols = cols;
+  for (line = 0, pos = 0; line < rows; line++)
+    pos = add_runs(picture, line, 0, cols, layout->row_runs, pos);
+  layout->row_runs[pos] = NG_RUN_LAST;
+  for (line = 0, pos = 0; line < cols; line++)
+    pos = add_runs(picture, line, 1, rows, layout->col_runs, pos);
+  layout->col_runs[pos] = NG_RUN_LAST;
+}
+
+/**
+ * @brief Generates a layout with exactly one solution
+ *
+ * @param difficulty NG_LINE_SOLVABLE or NG_NEEDS_GUESSING
+ * @param solution if non-NULL, receives the solved board
+ * @param budget the most pictures to try; each costs a run of the solver
+ * @return 0 on success, or -1 if the budget ran out first or the size is
+ *         too big
+ */
+int ng_generate(int rows, int cols, int difficulty, ng_layout_t *layout,
+                ng_board_t *solution, unsigned int budget) {
+  ng_line_t picture[NG_MAX_ROWS];
+  ng_compiled_t lay;
+  ng_board_t board;
+  int line_solvable;
+
+  if (rows < 1 || rows > NG_MAX_ROWS || cols < 1 || cols > NG_MAX_COLS ||
+      difficulty < 0 || difficulty >= NG_DIFFICULTIES)
+    return -1;
+
+  for (; budget > 0; budget--) {
+    random_picture(rows, cols, picture);
+    picture_clues(rows, cols, picture, layout);
+    if (ng_compile(layout, &lay) < 0)
+      return -1;
+
+    /* Lines alone either solve it, which makes it unique, or get stuck */
+    ng_board_init(&board, &lay);
+    line_solvable = ng_propagate(&board, &lay) == NG_SOLVED;
+    if (line_solvable != (difficulty == NG_LINE_SOLVABLE))
+      continue;
+    if (!line_solvable && ng_solve(&lay, &board, 2) != 1)
+      continue;
+
+    if (solution != 0)
+      *solution = board;
+    return 0;
+  }
+  return -1;
+}
@@ -0,0 +1,19 @@
+/**
+ * @file nonogram_gen.h
+ * @brief Random Nonogram generation
+ */
+
+#ifndef _NONOGRAM_GEN_H
+#define _NONOGRAM_GEN_H
+
+#include "nonogram_solver.h"
+
+/** Difficulties of generated layouts */
+#define NG_LINE_SOLVABLE 0  /**< solved one line at a time, with no guessing */
+#define NG_NEEDS_GUESSING 1 /**< unique, but only found by trial and error */
+#define NG_DIFFICULTIES 2
+
+int ng_generate(int rows, int cols, int difficulty, ng_layout_t *layout,
+                ng_board_t *solution, unsigned int budget);
+
+#endif /* _NONOGRAM_GEN_H */
@@ -0,0 +1,83 @@
+/**
+ * @file nonogram_layout.c
+ * @brief Compiles Nonogram layouts into directly indexable tables
+ */
+
+#include "nonogram_layout.h"
+
+/**
+ * @brief Appends the lines of one run array to a compiled layout
+ *
+ * @return the index in out->runs after the last run added, or -1 if the
+ *         array doesn't have exactly 'count' lines whose runs fit in 'len'
+ *         cells
+ */
+static int compile_lines(const int *run_array, int first, int count, int len,
+                         int pos, ng_compiled_t *out) {
+  int line, span;
+
+  for (line = first; line < first + count; line++) {
+    out->offset[line] = pos;
+    out->nruns[line] = 0;
+    span = -1;
+    for (; *run_array != NG_RUN_END; run_array++) {
+      if (*run_array < 0 || pos == sizeof(out->runs))
+        return -1;
+      out->runs[pos++] = *run_array;
+      out->nruns[line]++;
+      span += *run_array + 1;
+    }
+    run_array++;
+    out->min_span[line] = span < 0 ? 0 : span;
+    if (span > len)
+      return -1;
+  }
+  return *run_array == NG_RUN_LAST ? pos : -1;
+}
+
+/**
+ * @brief Builds the per-line tables for a layout
+ *
+ * @return 0 on success, or -1 if the layout is malformed or too big
+ */
+int ng_compile(const ng_layout_t *layout, ng_compiled_t *out) {
+  int pos;
+
+  if (layout->rows < 1 || layout->rows > NG_MAX_ROWS ||
+      layout->cols < 1 || layout->cols > NG_MAX_COLS)
+    return -1;
+  out->rows = layout->rows;
+  out->cols = layout->cols;
+
+  pos = compile_lines(layout->row_runs, 0, layout->rows, layout->cols, 0, out);
+  if (pos < 0)
+    return -1;
+  pos = compile_lines(layout->col_runs, layout->rows, layout->cols,
+                      layout->rows, pos, out);
+  return pos < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Checks a line against its clue
+ *
+ * @param cells the line's filled cells; bit i is the i'th from the left (or
+ *        top)
+ * @return 1 if the filled cells form exactly the line's runs, 0 if not
+ */
+int ng_line_matches(const ng_compiled_t *lay, int line, unsigned int cells) {
+  const uint8_t *runs = NG_LINE_RUNS(lay, line);
+  int len = NG_LINE_LEN(lay, line);
+  int i = 0, n = 0, run;
+
+  while (i < len) {
+    if (!((cells >> i) & 1)) {
+      i++;
+      continue;
+    }
+    for (run = 0; i < len && ((cells >> i) & 1); i++)
+      run++;
+    if (n == lay->nruns[line] || runs[n++] != run)
+      return 0;
+  }
+  return n == lay->nruns[line];
+}
@@ -0,0 +1,49 @@
+/**
+ * @file nonogram_layout.h
+ * @brief Compiled form of Nonogram layouts
+ *
+ * The run arrays of an ng_layout_t have to be walked from the start to find
+ * the runs of any one line. ng_compile() turns a layout into per-line tables
+ * that can be indexed directly.
+ */
+
+#ifndef _NONOGRAM_LAYOUT_H
+#define _NONOGRAM_LAYOUT_H
+
+#include <stdint.h>
+#include "nonogram_db.h"
+
+/** Lines of a compiled layout: the rows, then the columns */
+#define NG_MAX_LINES (NG_MAX_ROWS + NG_MAX_COLS)
+
+typedef struct ng_compiled {
+  int rows;
+  int cols;
+
+  /** Runs of line i are runs[offset[i]] through runs[offset[i] + nruns[i] - 1] */
+  uint8_t offset[NG_MAX_LINES];
+  uint8_t nruns[NG_MAX_LINES];
+
+  /** Fewest cells the runs of line i fit in: their sum plus one per gap */
+  uint8_t min_span[NG_MAX_LINES];
+
+  /** Run lengths of all lines, back to back */
+  uint8_t runs[2 * NG_RUN_ELTS];
+} ng_compiled_t;
+
+/** Line number of row r */
+#define NG_ROW_LINE(lay, r) (r)
+
+/** Line number of column c */
+#define NG_COL_LINE(lay, c) ((lay)->rows + (c))
+
+/** Cells in line i */
+#define NG_LINE_LEN(lay, i) ((i) < (lay)->rows ? (lay)->cols : (lay)->rows)
+
+/** Runs of line i */
+#define NG_LINE_RUNS(lay, i) (&(lay)->runs[(lay)->offset[i]])
+
+int ng_compile(const ng_layout_t *layout, ng_compiled_t *out);
+int ng_line_matches(const ng_compiled_t *lay, int line, unsigned int cells);
+
+#endif /* _NONOGRAM_LAYOUT_H */
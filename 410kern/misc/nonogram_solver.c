@@ -0,0 +1,283 @@
+/**
+ * @file nonogram_solver.c
+ * @brief A solver (and validator) for Nonogram layouts
+ *
+ * Lines are solved as bitsets. For a line and what is known about its cells,
+ * the leftmost and rightmost placements of its runs consistent with that
+ * knowledge are found; every placement puts run i somewhere between the two.
+ * So cells which run i covers in both are certainly filled, and cells which
+ * no run can reach are certainly empty.
+ *
+ * A board is solved by solving lines until nothing more can be learned,
+ * revisiting only rows and columns that cross a cell which changed, and then
+ * guessing at an unknown cell and backtracking when a guess leads to a line
+ * with no placement at all.
+ *
+ * Layouts are taken in their compiled form (see nonogram_layout.h), so the
+ * runs of a line are found by indexing rather than by walking run arrays.
+ *
+ * ng_propagate() alone never guesses, so run on a board holding a player's
+ * marks, the cells it fills in are ones the player can deduce: hints.
+ */
+
+#include "nonogram_solver.h"
+
+/* Cells 0 through n - 1 of a line */
+#define LINE_MASK(n) ((1u << (n)) - 1)
+
+/**
+ * @brief Finds the leftmost placement of runs[i..nruns) starting at or after
+ *        cell p
+ *
+ * Each run must avoid known empty cells and must not be directly followed by
+ * a filled one, and no filled cell may be left between two runs. failed[i]
+ * remembers the p's from which runs[i..] can't be placed, which keeps this
+ * polynomial.
+ *
+ * @return 1 and fills in start[i..nruns) on success, or 0 if there is no
+ *         such placement
+ */
+static int place_left(const unsigned char *runs, int nruns, int i, int p,
+                      int len, ng_line_t filled, ng_line_t empty,
+                      unsigned char *start, ng_line_t *failed) {
+  int s;
+
+  if (p > len)
+    p = len;
+  if (i == nruns)
+    return (filled >> p) == 0;
+  if (failed[i] & (1u << p))
+    return 0;
+
+  for (s = p; s + runs[i] <= len; s++) {
+    ng_line_t run = LINE_MASK(runs[i]) << s;
+    if ((run & empty) == 0 && ((filled >> (s + runs[i])) & 1) == 0 &&
+        place_left(runs, nruns, i + 1, s + runs[i] + 1, len, filled, empty,
+                   start, failed)) {
+      start[i] = s;
+      return 1;
+    }
+    /* Sliding further right would leave this filled cell uncovered */
+    if ((filled >> s) & 1)
+      break;
+  }
+  failed[i] |= 1u << p;
+  return 0;
+}
+
+/* Mirrors the first len cells of a line */
+static ng_line_t reverse(ng_line_t line, int len) {
+  ng_line_t out = 0;
+  int i;
+
+  for (i = 0; i < len; i++)
+    if ((line >> i) & 1)
+      out |= 1u << (len - 1 - i);
+  return out;
+}
+
+/**
+ * @brief Deduces what it can about one line
+ *
+ * 'filled' and 'empty' give what is known of the line's len cells on entry,
+ * and have the deduced cells added on return.
+ *
+ * @return NG_CONTRADICTION if no placement of the runs fits what is known,
+ *         otherwise 1 if anything new was deduced and 0 if not
+ */
+int ng_line_solve(const unsigned char *runs, int nruns, int len,
+                  ng_line_t *filled, ng_line_t *empty) {
+  unsigned char left[NG_MAX_RUNS], right[NG_MAX_RUNS], mirrored[NG_MAX_RUNS];
+  ng_line_t failed[NG_MAX_RUNS];
+  ng_line_t new_filled = *filled, new_empty, reach = 0;
+  int i;
+
+  if (nruns > NG_MAX_RUNS)
+    return NG_CONTRADICTION;
+
+  for (i = 0; i < nruns; i++)
+    failed[i] = 0;
+  if (!place_left(runs, nruns, 0, 0, len, *filled, *empty, left, failed))
+    return NG_CONTRADICTION;
+
+  /* The rightmost placement is the leftmost one of the mirrored line */
+  for (i = 0; i < nruns; i++) {
+    mirrored[i] = runs[nruns - 1 - i];
+    failed[i] = 0;
+  }
+  if (!place_left(mirrored, nruns, 0, 0, len, reverse(*filled, len),
+                  reverse(*empty, len), right, failed))
+    return NG_CONTRADICTION;
+
+  for (i = 0; i < nruns; i++) {
+    int lo = left[i];
+    int hi = len - right[nruns - 1 - i] - runs[i];   /* rightmost start */
+
+    reach |= LINE_MASK(hi + runs[i]) & ~LINE_MASK(lo);
+    if (hi < lo + runs[i])
+      new_filled |= LINE_MASK(lo + runs[i]) & ~LINE_MASK(hi);
+  }
+
+  new_empty = *empty | (LINE_MASK(len) & ~reach);
+
+  if (new_filled == *filled && new_empty == *empty)
+    return 0;
+  *filled = new_filled;
+  *empty = new_empty;
+  return 1;
+}
+
+/**
+ * @brief Sets up a board with nothing known about any cell
+ */
+void ng_board_init(ng_board_t *board, const ng_compiled_t *lay) {
+  int r;
+
+  board->rows = lay->rows;
+  board->cols = lay->cols;
+  for (r = 0; r < NG_MAX_ROWS; r++) {
+    board->filled[r] = 0;
+    board->empty[r] = 0;
+  }
+  board->dirty_rows = LINE_MASK(board->rows);
+  board->dirty_cols = LINE_MASK(board->cols);
+}
+
+/* Solves row r of a board, queueing the columns it changes */
+static int solve_row(ng_board_t *board, const ng_compiled_t *lay, int r) {
+  int line = NG_ROW_LINE(lay, r);
+  ng_line_t filled = board->filled[r], empty = board->empty[r];
+
+  if (ng_line_solve(NG_LINE_RUNS(lay, line), lay->nruns[line], board->cols,
+                    &filled, &empty) < 0)
+    return NG_CONTRADICTION;
+  board->dirty_cols |= (filled & ~board->filled[r]) |
+                       (empty & ~board->empty[r]);
+  board->filled[r] = filled;
+  board->empty[r] = empty;
+  return 0;
+}
+
+/* Solves column c of a board, queueing the rows it changes */
+static int solve_col(ng_board_t *board, const ng_compiled_t *lay, int c) {
+  int line = NG_COL_LINE(lay, c);
+  ng_line_t filled = 0, empty = 0, old_filled, old_empty;
+  int r;
+
+  for (r = 0; r < board->rows; r++) {
+    filled |= ((board->filled[r] >> c) & 1) << r;
+    empty |= ((board->empty[r] >> c) & 1) << r;
+  }
+  old_filled = filled;
+  old_empty = empty;
+
+  if (ng_line_solve(NG_LINE_RUNS(lay, line), lay->nruns[line], board->rows,
+                    &filled, &empty) < 0)
+    return NG_CONTRADICTION;
+  board->dirty_rows |= (filled & ~old_filled) | (empty & ~old_empty);
+  for (r = 0; r < board->rows; r++) {
+    board->filled[r] |= ((filled >> r) & 1) << c;
+    board->empty[r] |= ((empty >> r) & 1) << c;
+  }
+  return 0;
+}
+
+/**
+ * @brief Solves dirty lines until no line yields anything more
+ *
+ * @return NG_SOLVED if every cell is known, NG_CONTRADICTION if some line
+ *         can't be completed, or NG_STUCK otherwise
+ */
+int ng_propagate(ng_board_t *board, const ng_compiled_t *lay) {
+  int r;
+
+  while (board->dirty_rows != 0 || board->dirty_cols != 0) {
+    int result;
+    if (board->dirty_rows != 0) {
+      r = __builtin_ctz(board->dirty_rows);
+      board->dirty_rows &= ~(1u << r);
+      result = solve_row(board, lay, r);
+    } else {
+      int c = __builtin_ctz(board->dirty_cols);
+      board->dirty_cols &= ~(1u << c);
+      result = solve_col(board, lay, c);
+    }
+    if (result < 0)
+      return NG_CONTRADICTION;
+  }
+
+  for (r = 0; r < board->rows; r++)
+    if ((board->filled[r] | board->empty[r]) != LINE_MASK(board->cols))
+      return NG_STUCK;
+  return NG_SOLVED;
+}
+
+/*
+ * The backtracking search keeps a board for each guess in a static stack
+ * (there can be one guess per cell, far too many boards for the kernel
+ * stack), so ng_solve() is not reentrant.
+ */
+typedef struct ng_frame {
+  ng_board_t board;     /* the board before this guess */
+  int row, col;         /* the guessed cell */
+  int untried;          /* nonzero if "empty" hasn't been tried yet */
+} ng_frame_t;
+
+static ng_frame_t frames[NG_MAX_ROWS * NG_MAX_COLS + 1];
+
+/**
+ * @brief Searches for up to 'limit' solutions of a layout
+ *
+ * The first solution found is stored in 'solution' if it is non-NULL. A limit
+ * of 2 is enough to validate a layout, which should have exactly one
+ * solution.
+ *
+ * @return the number of solutions found
+ */
+int ng_solve(const ng_compiled_t *lay, ng_board_t *solution, int limit) {
+  int depth = 0, found = 0;
+
+  ng_board_init(&frames[0].board, lay);
+
+  for (;;) {
+    ng_frame_t *f = &frames[depth];
+    int result = ng_propagate(&f->board, lay);
+    ng_board_t *next;
+
+    if (result == NG_STUCK) {
+      /* Guess at the first unknown cell, "filled" first */
+      int r = 0;
+      ng_line_t unknown;
+      while ((unknown = LINE_MASK(f->board.cols) &
+                        ~(f->board.filled[r] | f->board.empty[r])) == 0)
+        r++;
+      f->row = r;
+      f->col = __builtin_ctz(unknown);
+      f->untried = 1;
+      next = &frames[depth + 1].board;
+      *next = f->board;
+      next->filled[f->row] |= 1u << f->col;
+    } else {
+      if (result == NG_SOLVED && found++ == 0 && solution != 0)
+        *solution = f->board;
+      if (found >= limit)
+        break;
+
+      /* Back up to the most recent guess not yet tried both ways */
+      do {
+        if (--depth < 0)
+          return found;
+      } while (!frames[depth].untried);
+      f = &frames[depth];
+      f->untried = 0;
+      next = &frames[depth + 1].board;
+      *next = f->board;
+      next->empty[f->row] |= 1u << f->col;
+    }
+
+    next->dirty_rows = 1u << f->row;
+    next->dirty_cols = 1u << f->col;
+    depth++;
+  }
+  return found;
+}
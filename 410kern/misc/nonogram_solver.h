@@ -0,0 +1,49 @@
+/**
+ * @file nonogram_solver.h
+ * @brief Definitions for solving Nonogram layouts
+ */
+
+#ifndef _NONOGRAM_SOLVER_H
+#define _NONOGRAM_SOLVER_H
+
+#include "nonogram_layout.h"
+
+/** A row or column as a set of cells; bit i is the i'th cell from the left
+ *  (or top) */
+typedef unsigned int ng_line_t;
+
+#if NG_MAX_ROWS > 31 || NG_MAX_COLS > 31
+#error "ng_line_t can't hold a line of the largest layout"
+#endif
+
+/** Most runs a line can have */
+#define NG_MAX_RUNS \
+  (((NG_MAX_ROWS > NG_MAX_COLS ? NG_MAX_ROWS : NG_MAX_COLS) + 1) / 2)
+
+/** Results of ng_line_solve(), ng_propagate() and friends */
+#define NG_CONTRADICTION (-1)
+#define NG_STUCK 0
+#define NG_SOLVED 1
+
+/**
+ * What is known about each cell of a board: a cell is filled if its bit is
+ * set in filled[row], empty if its bit is set in empty[row], and unknown if
+ * neither is.
+ */
+typedef struct ng_board {
+  int rows;
+  int cols;
+  ng_line_t filled[NG_MAX_ROWS];
+  ng_line_t empty[NG_MAX_ROWS];
+  /** Lines whose cells changed since they were last solved */
+  ng_line_t dirty_rows;
+  ng_line_t dirty_cols;
+} ng_board_t;
+
+int ng_line_solve(const unsigned char *runs, int nruns, int len,
+                  ng_line_t *filled, ng_line_t *empty);
+void ng_board_init(ng_board_t *board, const ng_compiled_t *lay);
+int ng_propagate(ng_board_t *board, const ng_compiled_t *lay);
+int ng_solve(const ng_compiled_t *lay, ng_board_t *solution, int limit);
+
+#endif /* _NONOGRAM_SOLVER_H */
@@ -0,0 +1,180 @@
+/**
+ * @brief A complete sudoku solver
+ *
+ * The mask engine's singles are applied until they run out, and then the
+ * blank cell with the fewest candidates is guessed (trying each candidate in
+ * turn) and the singles are applied again, backtracking on contradictions.
+ * Choosing the most constrained cell keeps the tree small; for the puzzles in
+ * sudokudb it rarely has more than a handful of nodes.
+ *
+ * The search is iterative, keeping a copy of the engine state for each guess
+ * in a static stack, since a 9x9 grid can be up to SU_GRID_AREA guesses deep
+ * and the kernel stack is far too small to hold that many states. As a
+ * consequence, none of these functions are reentrant.
+ */
+
+#include "searchsolver.h"
+#include "masksolver.h"
+#include "sudokudb.h"
+
+typedef struct su_frame {
+  su_masks_t m;          /* state before this guess was made */
+  unsigned short untried; /* candidates of the guessed cell left to try */
+  unsigned char row, col; /* the guessed cell */
+} su_frame_t;
+
+/* frames[d] is the state at depth d of the search */
+static su_frame_t frames[SU_GRID_AREA + 1];
+
+/**
+ * @brief Finds the blank cell with the fewest candidates
+ *
+ * @return the number of candidates of the chosen cell
+ */
+static int choose_cell(su_masks_t *m, int *brow, int *bcol) {
+  int row, col, best = SU_GRID_SIZE + 1;
+
+  for (row = 0; row < SU_GRID_SIZE; row++) {
+    for (col = 0; col < SU_GRID_SIZE; col++) {
+      int count;
+      if (m->grid[row][col] != 0)
+        continue;
+      count = su_count(su_candidates(m, row, col));
+      if (count < best) {
+        best = count;
+        *brow = row;
+        *bcol = col;
+        if (count <= 1)
+          return count;
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Searches for up to 'limit' solutions of 'sudoku'
+ *
+ * The first solution found is stored in 'solution' if it is non-NULL, and the
+ * effort spent is added to 'effort' if it is non-NULL.
+ *
+ * @return the number of solutions found
+ */
+static int search(sudoku_t sudoku, int limit, sudoku_t solution,
+                  su_effort_t *effort) {
+  int depth = 0, found = 0, row = 0, col = 0;
+  su_stats_t stats = { 0, 0 };
+  su_effort_t spent = { 0, 0, 0, 0 };
+
+  if (su_masks_init(&frames[0].m, sudoku) < 0)
+    return 0;
+
+  for (;;) {
+    su_frame_t *f = &frames[depth];
+    int result = su_propagate(&f->m, &stats);
+
+    if (result == SU_STUCK) {
+      /* Guess at the most constrained cell; the copy keeps the state to
+       * come back to for its other candidates */
+      if (choose_cell(&f->m, &row, &col) == 0) {
+        result = SU_CONTRADICTION;
+      } else {
+        f->row = row;
+        f->col = col;
+        f->untried = su_candidates(&f->m, row, col);
+        spent.guesses++;
+      }
+    } else if (result == SU_SOLVED) {
+      if (found++ == 0 && solution != 0) {
+        for (row = 0; row < SU_GRID_SIZE; row++)
+          for (col = 0; col < SU_GRID_SIZE; col++)
+            solution[row][col] = f->m.grid[row][col];
+      }
+      if (found >= limit)
+        break;
+    }
+
+    if (result != SU_STUCK) {
+      if (result == SU_CONTRADICTION)
+        spent.dead_ends++;
+      /* Back up to the most recent guess with candidates left to try */
+      do {
+        if (--depth < 0)
+          goto done;
+      } while (frames[depth].untried == 0);
+    }
+
+    /* Try the next candidate of the guess at 'depth' */
+    f = &frames[depth];
+    frames[depth + 1].m = f->m;
+    su_place(&frames[depth + 1].m, f->row, f->col,
+             __builtin_ctz(f->untried) + 1);
+    f->untried &= f->untried - 1;
+    depth++;
+  }
+
+done:
+  if (effort != 0) {
+    effort->naked += stats.naked;
+    effort->hidden += stats.hidden;
+    effort->guesses += spent.guesses;
+    effort->dead_ends += spent.dead_ends;
+  }
+  return found;
+}
+
+/**
+ * @brief Solves the given sudoku in place.
+ *
+ * Unlike semisolve() this always finishes a sudoku which has a solution. If
+ * there is more than one, the first found is used.
+ *
+ * @return 1 if the sudoku has been solved, or 0 if it has no solution
+ */
+int searchsolve(sudoku_t sudoku) {
+  return search(sudoku, 1, sudoku, 0);
+}
+
+/**
+ * @brief Counts the solutions of a sudoku, stopping at 'limit'
+ *
+ * A limit of 2 is enough to tell whether a puzzle is proper (has exactly one
+ * solution). The sudoku is not modified.
+ */
+int su_count_solutions(sudoku_t sudoku, int limit) {
+  return search(sudoku, limit, 0, 0);
+}
+
+/**
+ * @brief Measures how hard a sudoku is to solve
+ *
+ * The effort is that of proving the solution unique: the whole search tree is
+ * explored unless a second solution turns up. The sudoku is not modified.
+ *
+ * @return the number of solutions found, up to 2
+ */
+int su_rate(sudoku_t sudoku, su_effort_t *effort) {
+  effort->naked = effort->hidden = effort->guesses = effort->dead_ends = 0;
+  return search(sudoku, 2, 0, effort);
+}
+
+/**
+ * @brief Grades a measured effort on the 0 to (MAX_DIFFICULTY - 1) scale of
+ *        sudokudb
+ *
+ * Puzzles which fall to naked singles alone are the easiest, those needing
+ * hidden singles come next, and beyond that each doubling of the number of
+ * guesses adds a level.
+ */
+int su_difficulty(const su_effort_t *effort) {
+  int level;
+  unsigned int guesses;
+
+  if (effort->guesses == 0)
+    return effort->hidden == 0 ? 0 : 1;
+
+  level = 2;
+  for (guesses = effort->guesses; guesses > 1; guesses >>= 1)
+    level++;
+  return level < MAX_DIFFICULTY ? level : MAX_DIFFICULTY - 1;
+}
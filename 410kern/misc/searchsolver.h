@@ -0,0 +1,24 @@
+/**
+ * @file searchsolver.h
+ * @brief Headers for the complete (backtracking) sudoku solver
+ */
+
+#ifndef _SEARCHSOLVER_H
+#define _SEARCHSOLVER_H
+
+#include "sudoku.h"
+
+/* Effort spent by a search, which doubles as a measure of difficulty */
+typedef struct su_effort {
+  unsigned int naked;       /* naked singles placed */
+  unsigned int hidden;      /* hidden singles placed */
+  unsigned int guesses;     /* cells where the search had to branch */
+  unsigned int dead_ends;   /* guesses which led to a contradiction */
+} su_effort_t;
+
+int searchsolve(sudoku_t sudoku);
+int su_count_solutions(sudoku_t sudoku, int limit);
+int su_rate(sudoku_t sudoku, su_effort_t *effort);
+int su_difficulty(const su_effort_t *effort);
+
+#endif /* _SEARCHSOLVER_H */
@@ -22,13 +22,19 @@
 #define SOK_ROCK ('b')
 #define SOK_GOAL ('g')
 
+// Directions a pusher can move in, and push rocks in
+#define SOKO_UP    0
+#define SOKO_RIGHT 1
+#define SOKO_DOWN  2
+#define SOKO_LEFT  3
+
 typedef struct sokolevel {
   int width;
   int height;
   char * map;
 } sokolevel_t;
 
-sokolevel_t *soko_levels[MAX_LEVELS];
-int soko_nlevels;
+extern sokolevel_t *soko_levels[MAX_LEVELS];
+extern int soko_nlevels;
 
 #endif /* _SOKOBAN_H_ */
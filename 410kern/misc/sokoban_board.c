@@ -0,0 +1,122 @@
+/** @file sokoban_board.c
+ *  @brief Moving the pusher around a sokoban board
+ */
+
+#include "sokoban_board.h"
+
+#define PLAYER_X(b) ((int)SOKO_X((b)->player))
+#define PLAYER_Y(b) ((int)SOKO_Y((b)->player))
+
+static const int dir_dx[4] = { 0, 1, 0, -1 };
+static const int dir_dy[4] = { -1, 0, 1, 0 };
+
+/** @brief Is (x, y) a wall, or outside the level? */
+static int walled(const soko_board_t *b, int x, int y)
+{
+  if ((unsigned)x >= b->width || (unsigned)y >= b->height)
+    return 1;
+  return SOKO_AT(b->wall, x, y);
+}
+
+/** @brief Builds the bitboards of a level, ready to play
+ *  @return 0 on success, or -1 if the level is too big or has no pusher
+ */
+int soko_board_init(soko_board_t *b, const sokolevel_t *level)
+{
+  int x, y, pusher = 0;
+
+  if (level->width <= 0 || level->width > SOKO_BOARD_WIDTH ||
+      level->height <= 0 || level->height > SOKO_BOARD_HEIGHT)
+    return -1;
+  b->width = level->width;
+  b->height = level->height;
+  b->rocks = b->rocks_on_goals = 0;
+
+  for (y = 0; y < SOKO_BOARD_HEIGHT; y++)
+    b->wall[y] = b->rock[y] = b->goal[y] = 0;
+
+  for (y = 0; y < b->height; y++) {
+    for (x = 0; x < b->width; x++) {
+      switch (level->map[y * b->width + x]) {
+      case '\0':
+        return -1;
+      case SOK_WALL:
+        b->wall[y] |= 1u << x;
+        break;
+      case SOK_ROCK:
+        b->rock[y] |= 1u << x;
+        b->rocks++;
+        break;
+      case SOK_GOAL:
+        b->goal[y] |= 1u << x;
+        break;
+      case SOK_PUSH:
+        b->player = SOKO_PACK(x, y);
+        pusher++;
+        break;
+      }
+    }
+  }
+  return pusher == 1 ? 0 : -1;
+}
+
+/** @brief Moves the pusher one square, pushing the rock in the way if
+ *         there is one and it has room to move
+ *  @param dir SOKO_UP, SOKO_RIGHT, SOKO_DOWN or SOKO_LEFT
+ *  @return a move to give soko_board_undo(), or -1 if the pusher can't move
+ */
+int soko_board_move(soko_board_t *b, int dir)
+{
+  int x = PLAYER_X(b) + dir_dx[dir], y = PLAYER_Y(b) + dir_dy[dir];
+  int rx, ry;
+
+  if (walled(b, x, y))
+    return -1;
+  if (!SOKO_AT(b->rock, x, y)) {
+    b->player = SOKO_PACK(x, y);
+    return dir;
+  }
+
+  rx = x + dir_dx[dir];
+  ry = y + dir_dy[dir];
+  if (walled(b, rx, ry) || SOKO_AT(b->rock, rx, ry))
+    return -1;
+
+  b->rock[y] &= ~(1u << x);
+  b->rock[ry] |= 1u << rx;
+  b->rocks_on_goals += SOKO_AT(b->goal, rx, ry) - SOKO_AT(b->goal, x, y);
+  b->player = SOKO_PACK(x, y);
+  return dir | SOKO_MOVE_PUSHED;
+}
+
+/** @brief Takes back the last move, which soko_board_move() returned */
+void soko_board_undo(soko_board_t *b, int move)
+{
+  int dir = SOKO_MOVE_DIR(move);
+  int x = PLAYER_X(b), y = PLAYER_Y(b);
+
+  if (move & SOKO_MOVE_PUSHED) {
+    int rx = x + dir_dx[dir], ry = y + dir_dy[dir];
+    b->rock[ry] &= ~(1u << rx);
+    b->rock[y] |= 1u << x;
+    b->rocks_on_goals += SOKO_AT(b->goal, x, y) - SOKO_AT(b->goal, rx, ry);
+  }
+  b->player = SOKO_PACK(x - dir_dx[dir], y - dir_dy[dir]);
+}
+
+/** @brief What to draw at (x, y)
+ *  @return SOK_WALL, SOK_PUSH, SOK_ROCK, SOK_GOAL or ' ', as in level maps.
+ *          A rock or pusher on a goal is returned as the rock or pusher.
+ */
+char soko_board_cell(const soko_board_t *b, int x, int y)
+{
+  if (SOKO_AT(b->wall, x, y))
+    return SOK_WALL;
+  if (SOKO_PACK(x, y) == b->player)
+    return SOK_PUSH;
+  if (SOKO_AT(b->rock, x, y))
+    return SOK_ROCK;
+  if (SOKO_AT(b->goal, x, y))
+    return SOK_GOAL;
+  return ' ';
+}
@@ -0,0 +1,51 @@
+/** @file sokoban_board.h
+ *  @brief A sokoban level in play, kept as bitboards
+ *
+ *  Each row of the level is a word with bit x set for the walls, rocks or
+ *  goals in column x, so moving is a few bit tests, and a running count of
+ *  the rocks on goals makes checking for a win one comparison.
+ */
+
+#ifndef _SOKOBAN_BOARD_H_
+#define _SOKOBAN_BOARD_H_
+
+#include "sokoban.h"
+
+// Largest level a board holds
+#define SOKO_BOARD_WIDTH  32
+#define SOKO_BOARD_HEIGHT 32
+
+typedef unsigned int soko_row_t;
+
+typedef struct soko_board {
+  unsigned char width;
+  unsigned char height;
+  // Where the pusher is, as SOKO_PACK(x, y)
+  unsigned short player;
+  unsigned short rocks;
+  unsigned short rocks_on_goals;
+  soko_row_t wall[SOKO_BOARD_HEIGHT];
+  soko_row_t rock[SOKO_BOARD_HEIGHT];
+  soko_row_t goal[SOKO_BOARD_HEIGHT];
+} soko_board_t;
+
+#define SOKO_PACK(x, y) ((y) << 5 | (x))
+#define SOKO_X(pos)     ((pos) & 31)
+#define SOKO_Y(pos)     ((pos) >> 5)
+
+#define SOKO_AT(rows, x, y) (((rows)[y] >> (x)) & 1)
+
+// soko_board_move() returns the direction moved, plus this if it pushed a
+// rock; soko_board_undo() takes the same value back
+#define SOKO_MOVE_PUSHED 4
+#define SOKO_MOVE_DIR(move) ((move) & 3)
+
+// Has every rock been pushed onto a goal?
+#define SOKO_BOARD_WON(b) ((b)->rocks_on_goals == (b)->rocks)
+
+int soko_board_init(soko_board_t *b, const sokolevel_t *level);
+int soko_board_move(soko_board_t *b, int dir);
+void soko_board_undo(soko_board_t *b, int move);
+char soko_board_cell(const soko_board_t *b, int x, int y);
+
+#endif /* _SOKOBAN_BOARD_H_ */
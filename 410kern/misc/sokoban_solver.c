@@ -0,0 +1,1341 @@
+/** @file sokoban_solver.c
+ *  @brief A push-optimal sokoban solver
+ *
+ *  The search is A* over pushes. Walking between pushes is free: a
+ *  position is identified by where the rocks are and by which region of
+ *  the level the pusher can walk around in, so the pusher is recorded as
+ *  the lowest-numbered square it can reach ("normalized").
+ *
+ *  The estimate of the pushes still needed is a minimum-cost matching of
+ *  rocks to goals, where pairing a rock with a goal costs the pushes it
+ *  would need to get there if the other rocks weren't there -- counting
+ *  from the side of it the pusher can get to, as in a corridor a rock may
+ *  only be pushable one way. Each goal takes one rock, so this never
+ *  overestimates, and the first solution found uses the fewest pushes
+ *  possible. It is also a deadlock test: a position whose rocks can't all
+ *  be given different reachable goals is dropped. The matching is found in
+ *  full (Hungarian method) for the position being expanded; a push moves
+ *  one rock, so a child's is usually found from it with a single
+ *  augmenting path.
+ *
+ *  Only the squares the pusher can ever reach ("floor") matter, so they
+ *  are numbered from 0 and the rocks of a position are kept as a bitboard
+ *  over floor squares -- for the usual levels, a word to a dozen.
+ *
+ *  Pushes that can be seen to lose are never made:
+ *   - onto dead squares, from which no rock can reach any goal;
+ *   - freezing a rock off its goal: a rock is frozen if it can't move
+ *     along either axis, because of walls, dead squares on both sides, or
+ *     other frozen rocks;
+ *   - closing a corral that isn't finished but whose rocks the pusher
+ *     couldn't push even if every other rock were gone. A corral is a part
+ *     of the level the pusher can't reach, with the rocks fencing it; the
+ *     first thing that can change in it is a push of one of those rocks.
+ *
+ *  Some runs of pushes are made as one step ("macros"):
+ *   - a rock pushed into a tunnel (walls on both sides of it and of the
+ *     pusher behind it) is pushed on until it leaves, as stopping part way
+ *     can't help anything;
+ *   - if the goals sit in a room with a single, one-square entrance, a
+ *     rock pushed into the entrance goes straight on to the next goal in a
+ *     fill order planned at the start. The plan is only used if every rock
+ *     in it takes the fewest pushes it could take into an empty room, so
+ *     it costs no more than any other way of filling the room. Rocks
+ *     already in the room when the search starts are taken to stay put.
+ *
+ *  The search is "partial expansion" A*: a position's children are stored
+ *  only if their estimated cost equals the one being searched, and the
+ *  position is queued again at the next higher cost of a child it held
+ *  back. Most pushes move a rock away from its goal, so most children are
+ *  never stored at all.
+ *
+ *  Every position stored is kept in a pool of memory supplied by the
+ *  caller (from lmm, say, or a static array), together with a hash table
+ *  of the positions used to discard repeats. The pool is all the memory
+ *  the search uses beyond some static tables, so when it fills up the
+ *  search gives up rather than growing. It also gives up after a fixed
+ *  amount of work. As those tables are static, the solver is not
+ *  reentrant.
+ *
+ *  Levels with too many rocks to search that way (an open room of them,
+ *  say, where they can be pushed in any order) are solved a goal at a
+ *  time instead, in an order worked out backwards from the end, so that
+ *  each goal can still be reached once the ones before it are filled.
+ *  Each goal is filled with as few pushes as the same search can find,
+ *  but the whole solution may not be the shortest.
+ */
+
+#include "sokoban_solver.h"
+
+#define NOT_FLOOR (-1)
+
+#define MAX_WORDS ((SOKO_MAX_FLOOR + 31) / 32)
+
+#define BB_TEST(bb, i)  (((bb)[(i) >> 5] >> ((i) & 31)) & 1)
+#define BB_SET(bb, i)   ((bb)[(i) >> 5] |= 1u << ((i) & 31))
+#define BB_CLEAR(bb, i) ((bb)[(i) >> 5] &= ~(1u << ((i) & 31)))
+
+// Distance of a dead square
+#define DEAD 0xffff
+
+// What the matching charges for pairing a rock with a goal it can't
+// reach: more than any real pushes can add up to
+#define NO_MATCH 0x4000
+
+#define INFINITE 0x3fffffff
+
+// Largest estimated solution length (pushes so far plus estimate) the
+// search will consider
+#define MAX_COST 4096
+
+// Most pairings of a rock with a goal the search may cost before it gives
+// up on finding the fewest pushes, so that a hint never takes long
+#define MAX_WORK (1u << 25)
+
+// Most pushes the goal room's macros may take altogether, and most
+// partial fill orders tried while planning them
+#define MAX_ROOM_PUSHES 1024
+#define MAX_ROOM_TRIES  2000
+
+// A position in the pool is these words, followed by the rocks:
+#define REC_PARENT 0    // position it was reached from, or NO_PARENT
+#define REC_INFO   1    // pusher, push and pushes so far (see below)
+#define REC_NEXT   2    // next position + 1 with the same cost, or 0
+#define REC_ROCKS  3
+
+#define NO_PARENT 0x7fffffffu
+
+// Set in REC_PARENT of a position superseded by a shorter way to reach it
+#define STALE 0x80000000u
+
+// REC_INFO holds the normalized pusher square in bits 0-8, the first push
+// that led here (square << 2 | direction) in bits 9-19, and the number of
+// pushes from the start in bits 20-31.
+#define INFO(pusher, push, g) ((pusher) | (push) << 9 | (g) << 20)
+#define INFO_PUSHER(info)     ((info) & 0x1ff)
+#define INFO_PUSH(info)       (((info) >> 9) & 0x7ff)
+#define INFO_G(info)          ((info) >> 20)
+#define PUSH_CODE(sq, dir)    ((sq) << 2 | (dir))
+
+#define MAX_G 0xfff
+
+#if SOKO_MAX_FLOOR > 512
+#error "REC_INFO can't hold a floor square number"
+#endif
+
+static const int dir_dx[4] = { 0, 1, 0, -1 };
+static const int dir_dy[4] = { -1, 0, 1, 0 };
+
+// The level being solved
+static int width, height;
+static int nfloor, nwords, nrocks, ngoals;
+static short floor_of[SOKO_MAX_CELLS];          // floor number, or NOT_FLOOR
+static unsigned short cell_of[SOKO_MAX_FLOOR];  // y * width + x of a floor
+static short neighbor[SOKO_MAX_FLOOR][4];       // floor, or NOT_FLOOR
+static unsigned short dist[SOKO_MAX_FLOOR];     // pushes to a goal, or DEAD
+static unsigned int goals[MAX_WORDS];
+static short goal_sq[SOKO_MAX_ROCKS];
+
+// For each side of each square, the lowest numbered side the pusher could
+// walk to from there if a lone rock stood on the square, or NO_SIDE if
+// there's no floor on that side
+#define NO_SIDE 4
+static unsigned char side_class[SOKO_MAX_FLOOR][4];
+
+// Pushes a lone rock needs to get from each square to each goal, by the
+// side of it the pusher is on, or DEAD
+static unsigned short goal_dist[SOKO_MAX_ROCKS][SOKO_MAX_FLOOR][4];
+
+// Scratch space for flood fills, of squares or of square * 4 + side
+static unsigned short queue[SOKO_MAX_FLOOR];
+static unsigned short state_queue[SOKO_MAX_FLOOR * 4];
+
+// The matching of the position being expanded: rock squares by row, the
+// cost of each pairing, the row potentials, the goal (column) potentials
+// and the row on each goal, all counted from 1. try_ are the same for a
+// child.
+static short row_sq[SOKO_MAX_ROCKS + 1];
+static int cost[SOKO_MAX_ROCKS + 1][SOKO_MAX_ROCKS + 1];
+static int try_cost[SOKO_MAX_ROCKS + 1][SOKO_MAX_ROCKS + 1];
+static int pot_u[SOKO_MAX_ROCKS + 1], pot_v[SOKO_MAX_ROCKS + 1];
+static int mate[SOKO_MAX_ROCKS + 1];
+static int try_u[SOKO_MAX_ROCKS + 1], try_v[SOKO_MAX_ROCKS + 1];
+static int try_mate[SOKO_MAX_ROCKS + 1];
+static int min_slack[SOKO_MAX_ROCKS + 1], way[SOKO_MAX_ROCKS + 1];
+static unsigned char used[SOKO_MAX_ROCKS + 1];
+
+// Rocks already found frozen, which count as walls, for freeze tests
+static unsigned int frozen_mark[MAX_WORDS];
+static int frozen_off_goal;
+
+// The goal room, if there is one (room_entrance isn't NOT_FLOOR): the
+// squares past the entrance, those plus the entrance and the square in
+// front of it, and the direction into the room
+static int room_entrance, room_dir;
+static unsigned int room_mask[MAX_WORDS], room_area[MAX_WORDS];
+static int room_placed;         // rocks in it at the start
+static int room_size;           // goals left to fill, in order:
+static short room_order[SOKO_MAX_ROCKS];
+static short room_pusher[SOKO_MAX_ROCKS];         // where the pusher ends
+static unsigned short room_start[SOKO_MAX_ROCKS + 1];
+static unsigned short room_path[MAX_ROOM_PUSHES]; // push codes
+static int room_tries;
+
+// Goals in the room, farthest from the entrance first, and how far
+static int room_ngoals;
+static short room_goal[SOKO_MAX_ROCKS];
+static unsigned short room_lb[SOKO_MAX_ROCKS];
+
+// Searches over a rock's moves, by rock square * 4 + the side of it the
+// pusher is on: how far, where from, and whether the side's been expanded
+static unsigned short state_dist[SOKO_MAX_FLOOR * 4];
+static unsigned short state_prev[SOKO_MAX_FLOOR * 4];
+static unsigned char state_done[SOKO_MAX_FLOOR * 4];
+
+// The order in which to fill the empty goals if the search gives up
+static short pack_order[SOKO_MAX_ROCKS];
+static int pack_size;
+
+// While filling them one at a time, the one to fill next (or NOT_FLOOR),
+// its column in the matching, and the goals filled, whose rocks stay put
+static int target, target_col;
+static unsigned int placed[MAX_WORDS];
+
+// Heads (position + 1) of the lists of positions of each estimated cost
+static unsigned int open[MAX_COST];
+
+// Pairings costed by the search so far
+static unsigned int work;
+
+// The pool: a hash table of position numbers + 1 (0 is empty), and then
+// the positions themselves, rec_words words each
+static unsigned int *table;
+static unsigned int table_mask;
+static unsigned int *positions;
+static unsigned int npositions, max_positions, rec_words;
+
+/** @brief Numbers the floor squares of a level and finds its goals
+ *  @return 0 and sets *rocks on success, or SOKO_BAD_LEVEL
+ */
+static int read_level(const sokolevel_t *level, unsigned int *rocks,
+                      int *pusher)
+{
+  int cell, x, y, d, head;
+  const char *map = level->map;
+
+  width = level->width;
+  height = level->height;
+  if (width <= 0 || height <= 0 || width * height > SOKO_MAX_CELLS)
+    return SOKO_BAD_LEVEL;
+
+  *pusher = -1;
+  for (cell = 0; cell < width * height; cell++) {
+    if (map[cell] == '\0')
+      return SOKO_BAD_LEVEL;
+    if (map[cell] == SOK_PUSH)
+      *pusher = cell;
+    floor_of[cell] = NOT_FLOOR;
+  }
+  if (*pusher < 0)
+    return SOKO_BAD_LEVEL;
+
+  // Flood out from the pusher to find the floor, numbering it as we go
+  nfloor = 0;
+  floor_of[*pusher] = nfloor;
+  cell_of[nfloor++] = *pusher;
+  for (head = 0; head < nfloor; head++) {
+    cell = cell_of[head];
+    for (d = 0; d < 4; d++) {
+      x = cell % width + dir_dx[d];
+      y = cell / width + dir_dy[d];
+      if (x < 0 || x >= width || y < 0 || y >= height ||
+          map[y * width + x] == SOK_WALL || floor_of[y * width + x] >= 0)
+        continue;
+      if (nfloor == SOKO_MAX_FLOOR)
+        return SOKO_BAD_LEVEL;
+      floor_of[y * width + x] = nfloor;
+      cell_of[nfloor++] = y * width + x;
+    }
+  }
+  nwords = (nfloor + 31) / 32;
+
+  for (d = 0; d < MAX_WORDS; d++)
+    rocks[d] = goals[d] = 0;
+  nrocks = ngoals = 0;
+  for (cell = 0; cell < width * height; cell++) {
+    if (map[cell] != SOK_ROCK && map[cell] != SOK_GOAL)
+      continue;
+    // Rocks and goals shut away from the pusher can never be used
+    if (floor_of[cell] == NOT_FLOOR)
+      return SOKO_BAD_LEVEL;
+    if (map[cell] == SOK_ROCK) {
+      if (nrocks++ == SOKO_MAX_ROCKS)
+        return SOKO_BAD_LEVEL;
+      BB_SET(rocks, floor_of[cell]);
+    } else {
+      if (ngoals == SOKO_MAX_ROCKS)
+        return SOKO_BAD_LEVEL;
+      goal_sq[ngoals++] = floor_of[cell];
+      BB_SET(goals, floor_of[cell]);
+    }
+  }
+
+  for (head = 0; head < nfloor; head++) {
+    x = cell_of[head] % width;
+    y = cell_of[head] / width;
+    for (d = 0; d < 4; d++) {
+      int nx = x + dir_dx[d], ny = y + dir_dy[d];
+      neighbor[head][d] = (nx < 0 || nx >= width || ny < 0 || ny >= height) ?
+        NOT_FLOOR : floor_of[ny * width + nx];
+    }
+  }
+  return 0;
+}
+
+/** @brief Finds the squares the pusher can walk to from 'start'
+ *  @return the lowest numbered of them
+ */
+static int flood(const unsigned int *rocks, int start, unsigned int *reach)
+{
+  int i, d, head, tail = 1, lowest = start;
+
+  for (i = 0; i < nwords; i++)
+    reach[i] = 0;
+  BB_SET(reach, start);
+  queue[0] = start;
+
+  for (head = 0; head < tail; head++) {
+    for (d = 0; d < 4; d++) {
+      int next = neighbor[queue[head]][d];
+      if (next == NOT_FLOOR || BB_TEST(reach, next) || BB_TEST(rocks, next))
+        continue;
+      BB_SET(reach, next);
+      queue[tail++] = next;
+      if (next < lowest)
+        lowest = next;
+    }
+  }
+  return lowest;
+}
+
+/** @brief Sorts the sides of each square into those the pusher can walk
+ *         between with a lone rock on the square, and those it can't
+ */
+static void find_sides(void)
+{
+  unsigned int lone[MAX_WORDS], reach[MAX_WORDS];
+  int sq, d, e;
+
+  for (d = 0; d < nwords; d++)
+    lone[d] = 0;
+
+  for (sq = 0; sq < nfloor; sq++) {
+    for (d = 0; d < 4; d++)
+      side_class[sq][d] = NO_SIDE;
+    BB_SET(lone, sq);
+    for (d = 0; d < 4; d++) {
+      if (neighbor[sq][d] == NOT_FLOOR || side_class[sq][d] != NO_SIDE)
+        continue;
+      flood(lone, neighbor[sq][d], reach);
+      for (e = d; e < 4; e++)
+        if (neighbor[sq][e] != NOT_FLOOR && BB_TEST(reach, neighbor[sq][e]))
+          side_class[sq][e] = d;
+    }
+    BB_CLEAR(lone, sq);
+  }
+}
+
+/** @brief Finds how many pushes a lone rock needs to reach each goal from
+ *         each square, and the nearest goal
+ *
+ *  Works backwards from a goal: if a rock on a can get to the goal with
+ *  the pusher on some side of it, it can get there from the square behind
+ *  a whenever the pusher can push it from there to a and end up on that
+ *  side. Squares never reached are dead.
+ */
+static void find_distances(void)
+{
+  int i, g, d, e, head, tail;
+  unsigned short (*to_goal)[4];
+
+  for (i = 0; i < nfloor; i++)
+    dist[i] = DEAD;
+
+  for (g = 0; g < ngoals; g++) {
+    to_goal = goal_dist[g];
+    for (i = 0; i < nfloor; i++)
+      for (d = 0; d < 4; d++)
+        to_goal[i][d] = DEAD;
+    tail = 0;
+    for (d = 0; d < 4; d++) {
+      if (side_class[goal_sq[g]][d] == NO_SIDE)
+        continue;
+      to_goal[goal_sq[g]][d] = 0;
+      if (side_class[goal_sq[g]][d] == d)
+        state_queue[tail++] = goal_sq[g] * 4 + d;
+    }
+
+    for (head = 0; head < tail; head++) {
+      int to = state_queue[head] >> 2, side = state_queue[head] & 3;
+      for (d = 0; d < 4; d++) {
+        // A push in direction d leaves the pusher on side d ^ 2
+        int from = neighbor[to][d ^ 2], behind;
+        if (from == NOT_FLOOR || side_class[to][d ^ 2] != side)
+          continue;
+        behind = side_class[from][d ^ 2];
+        if (behind == NO_SIDE || to_goal[from][behind] != DEAD)
+          continue;
+        for (e = 0; e < 4; e++)
+          if (side_class[from][e] == behind)
+            to_goal[from][e] = to_goal[to][side] + 1;
+        state_queue[tail++] = from * 4 + behind;
+      }
+    }
+
+    for (i = 0; i < nfloor; i++)
+      for (d = 0; d < 4; d++)
+        if (to_goal[i][d] < dist[i])
+          dist[i] = to_goal[i][d];
+  }
+}
+
+static int rock_frozen(const unsigned int *rocks, int sq);
+
+/** @brief Can't the rock on sq move along the axis of direction 'axis'? */
+static int axis_blocked(const unsigned int *rocks, int sq, int axis)
+{
+  int a = neighbor[sq][axis], b = neighbor[sq][axis + 2];
+
+  if (a == NOT_FLOOR || b == NOT_FLOOR ||
+      BB_TEST(frozen_mark, a) || BB_TEST(frozen_mark, b))
+    return 1;
+  if (dist[a] == DEAD && dist[b] == DEAD)
+    return 1;
+  return (BB_TEST(rocks, a) && rock_frozen(rocks, a)) ||
+         (BB_TEST(rocks, b) && rock_frozen(rocks, b));
+}
+
+/** @brief Can't the rock on sq ever move again?
+ *
+ *  While a rock is being tested it counts as a wall for the rocks next to
+ *  it, which is what it turns out to be if it is frozen. Sets
+ *  frozen_off_goal if a frozen rock found on the way is off its goal.
+ */
+static int rock_frozen(const unsigned int *rocks, int sq)
+{
+  int frozen;
+
+  BB_SET(frozen_mark, sq);
+  frozen = axis_blocked(rocks, sq, SOKO_UP) &&
+           axis_blocked(rocks, sq, SOKO_RIGHT);
+  BB_CLEAR(frozen_mark, sq);
+  if (frozen && !BB_TEST(goals, sq))
+    frozen_off_goal = 1;
+  return frozen;
+}
+
+/** @brief Did the rock just pushed to sq freeze a rock off its goal? */
+static int freeze_deadlock(const unsigned int *rocks, int sq)
+{
+  frozen_off_goal = 0;
+  return rock_frozen(rocks, sq) && frozen_off_goal;
+}
+
+/** @brief Did the rock just pushed to sq close off an unfinished corral
+ *         that can never be opened?
+ *
+ *  The corral is everything the pusher can't reach that is connected to
+ *  sq, rocks included. It is finished if each of its rocks is on a goal
+ *  and each of its goals has a rock. Otherwise one of its rocks has to be
+ *  pushed some time, from a square the pusher can reach now, onto a square
+ *  no rock outside the corral could be in the way of -- so if no such push
+ *  exists, the position is lost.
+ */
+static int corral_deadlock(const unsigned int *rocks, const unsigned int *reach,
+                           int sq)
+{
+  static unsigned int corral[MAX_WORDS];
+  int i, d, head, tail = 1, finished = 1;
+
+  for (i = 0; i < nwords; i++)
+    corral[i] = 0;
+  BB_SET(corral, sq);
+  queue[0] = sq;
+
+  for (head = 0; head < tail; head++) {
+    i = queue[head];
+    if (BB_TEST(rocks, i) != BB_TEST(goals, i))
+      finished = 0;
+    for (d = 0; d < 4; d++) {
+      int next = neighbor[i][d];
+      if (next == NOT_FLOOR || BB_TEST(reach, next) || BB_TEST(corral, next))
+        continue;
+      BB_SET(corral, next);
+      queue[tail++] = next;
+    }
+  }
+  if (finished)
+    return 0;
+
+  for (head = 0; head < tail; head++) {
+    i = queue[head];
+    if (!BB_TEST(rocks, i))
+      continue;
+    for (d = 0; d < 4; d++) {
+      int to = neighbor[i][d], from = neighbor[i][d ^ 2];
+      if (from != NOT_FLOOR && BB_TEST(reach, from) && to != NOT_FLOOR &&
+          !BB_TEST(rocks, to) && dist[to] != DEAD)
+        return 0;
+    }
+  }
+  return 1;
+}
+
+/** @brief The pushes it takes a lone rock on sq to reach goal column j,
+ *         the pusher being able to walk to the squares in reach
+ *
+ *  With other rocks in the way the pusher may not reach the rock at all
+ *  yet, and then any side of it will do.
+ */
+static int pair_cost(int sq, int j, const unsigned int *reach)
+{
+  const unsigned short *sides = goal_dist[j - 1][sq];
+  int d, low = DEAD;
+
+  for (d = 0; d < 4; d++) {
+    if (side_class[sq][d] == NO_SIDE)
+      continue;
+    if (BB_TEST(reach, neighbor[sq][d]))
+      return sides[d] == DEAD ? NO_MATCH : sides[d];
+    if (sides[d] < low)
+      low = sides[d];
+  }
+  return low == DEAD ? NO_MATCH : low;
+}
+
+static void find_costs(int (*c)[SOKO_MAX_ROCKS + 1], const unsigned int *reach)
+{
+  int i, j;
+
+  for (i = 1; i <= nrocks; i++)
+    for (j = 1; j <= ngoals; j++)
+      c[i][j] = pair_cost(row_sq[i], j, reach);
+  work += nrocks * ngoals;
+}
+
+/** @brief Adds row 'row' to a matching along a shortest augmenting path
+ *
+ *  This is the Hungarian method's step, for rows u, columns v and the row
+ *  matched to each column, p. Every other row must already be matched
+ *  with no slack, and no pairing may have negative slack.
+ */
+static void augment(int row, int (*c)[SOKO_MAX_ROCKS + 1], int *u, int *v,
+                    int *p)
+{
+  int j, j0 = 0, j1 = 0, i0, delta, slack;
+
+  p[0] = row;
+  for (j = 0; j <= ngoals; j++) {
+    min_slack[j] = INFINITE;
+    used[j] = 0;
+  }
+
+  do {
+    used[j0] = 1;
+    i0 = p[j0];
+    delta = INFINITE;
+    for (j = 1; j <= ngoals; j++) {
+      if (used[j])
+        continue;
+      slack = c[i0][j] - u[i0] - v[j];
+      if (slack < min_slack[j]) {
+        min_slack[j] = slack;
+        way[j] = j0;
+      }
+      if (min_slack[j] < delta) {
+        delta = min_slack[j];
+        j1 = j;
+      }
+    }
+    for (j = 0; j <= ngoals; j++) {
+      if (used[j]) {
+        u[p[j]] += delta;
+        v[j] -= delta;
+      } else {
+        min_slack[j] -= delta;
+      }
+    }
+    j0 = j1;
+  } while (p[j0] != 0);
+
+  do {
+    j1 = way[j0];
+    p[j0] = p[j1];
+    j0 = j1;
+  } while (j0 != 0);
+}
+
+static int matched_cost(int (*c)[SOKO_MAX_ROCKS + 1], const int *p)
+{
+  int j, total = 0;
+
+  for (j = 1; j <= ngoals; j++)
+    if (p[j] != 0)
+      total += c[p[j]][j];
+  return total;
+}
+
+static void match_rows(int (*c)[SOKO_MAX_ROCKS + 1], int *u, int *v, int *p)
+{
+  int i;
+
+  for (i = 0; i <= ngoals; i++)
+    u[i] = v[i] = p[i] = 0;
+  for (i = 1; i <= nrocks; i++)
+    augment(i, c, u, v, p);
+}
+
+/** @brief The pushes it takes the nearest rock not yet put in place to
+ *         reach the target goal
+ */
+static int nearest(const unsigned int *reach)
+{
+  int i, c, low = NO_MATCH;
+
+  for (i = 1; i <= nrocks; i++) {
+    if (BB_TEST(placed, row_sq[i]))
+      continue;
+    c = pair_cost(row_sq[i], target_col, reach);
+    if (c < low)
+      low = c;
+  }
+  work += nrocks;
+  return low;
+}
+
+/** @brief Estimates the pushes a position needs, numbering its rocks in
+ *         row_sq for estimate_moved()
+ *
+ *  That's the cost of matching the rocks to goals from scratch, or of
+ *  filling just the target goal if there is one.
+ *
+ *  @return the estimate: NO_MATCH or more if it can't be done
+ */
+static int estimate(const unsigned int *rocks, const unsigned int *reach)
+{
+  int i, row = 0;
+
+  for (i = 0; i < nfloor; i++)
+    if (BB_TEST(rocks, i))
+      row_sq[++row] = i;
+  if (target != NOT_FLOOR)
+    return nearest(reach);
+  find_costs(cost, reach);
+  match_rows(cost, pot_u, pot_v, mate);
+  return matched_cost(cost, mate);
+}
+
+/** @brief estimate() for the position with rock 'row' moved to sq, after
+ *         which the pusher can walk to the squares in reach
+ *
+ *  If the other rocks' costs are unchanged and there are as many goals as
+ *  rocks, the old matching, less that rock, is still optimal for the rest,
+ *  and one augmenting path puts the rock back.
+ */
+static int estimate_moved(int row, int sq, const unsigned int *reach)
+{
+  int old = row_sq[row], i, j, low, total, same = (nrocks == ngoals);
+
+  row_sq[row] = sq;
+  if (target != NOT_FLOOR) {
+    total = nearest(reach);
+    row_sq[row] = old;
+    return total;
+  }
+  find_costs(try_cost, reach);
+  for (i = 1; i <= nrocks && same; i++)
+    for (j = 1; j <= ngoals && same; j++)
+      same = i == row || try_cost[i][j] == cost[i][j];
+
+  if (same) {
+    for (i = 0; i <= ngoals; i++) {
+      try_u[i] = pot_u[i];
+      try_v[i] = pot_v[i];
+      try_mate[i] = mate[i] == row ? 0 : mate[i];
+    }
+    low = INFINITE;
+    for (j = 1; j <= ngoals; j++)
+      if (try_cost[row][j] - try_v[j] < low)
+        low = try_cost[row][j] - try_v[j];
+    try_u[row] = low;
+    augment(row, try_cost, try_u, try_v, try_mate);
+  } else {
+    match_rows(try_cost, try_u, try_v, try_mate);
+  }
+  total = matched_cost(try_cost, try_mate);
+  row_sq[row] = old;
+  return total;
+}
+
+/** @brief Are there walls on both sides of sq, across direction dir? */
+static int tunnel(int sq, int dir)
+{
+  return neighbor[sq][dir ^ 1] == NOT_FLOOR &&
+         neighbor[sq][dir ^ 3] == NOT_FLOOR;
+}
+
+static int room_rocks(const unsigned int *rocks)
+{
+  int i, n = 0;
+
+  for (i = 0; i < nwords; i++) {
+    unsigned int w = rocks[i] & room_mask[i];
+    for (; w != 0; w &= w - 1)
+      n++;
+  }
+  return n - room_placed;
+}
+
+/** @brief Finds the fewest pushes a lone rock in the room's entrance,
+ *         with the pusher in front of it, needs to reach each square of
+ *         the room, around the rocks in 'obstacles'
+ */
+static void room_search(const unsigned int *obstacles)
+{
+  unsigned int blocked[MAX_WORDS], reach[MAX_WORDS];
+  int i, d, head, tail = 1;
+
+  for (i = 0; i < nwords; i++)
+    blocked[i] = ~room_area[i] | obstacles[i];
+  for (i = 0; i < nfloor * 4; i++)
+    state_dist[i] = DEAD;
+  state_queue[0] = room_entrance * 4 + (room_dir ^ 2);
+  state_dist[state_queue[0]] = 0;
+
+  for (head = 0; head < tail; head++) {
+    int state = state_queue[head], sq = state >> 2;
+
+    BB_SET(blocked, sq);
+    flood(blocked, neighbor[sq][state & 3], reach);
+    BB_CLEAR(blocked, sq);
+
+    for (d = 0; d < 4; d++) {
+      int to = neighbor[sq][d], from = neighbor[sq][d ^ 2], next;
+      if (from == NOT_FLOOR || !BB_TEST(reach, from) || to == NOT_FLOOR ||
+          !BB_TEST(room_mask, to) || BB_TEST(obstacles, to))
+        continue;
+      next = to * 4 + (d ^ 2);
+      if (state_dist[next] != DEAD)
+        continue;
+      state_dist[next] = state_dist[state] + 1;
+      state_prev[next] = state;
+      state_queue[tail++] = next;
+    }
+  }
+}
+
+/** @brief The state in which room_search() got a rock to sq soonest */
+static int room_best(int sq)
+{
+  int side, best = sq * 4;
+
+  for (side = 1; side < 4; side++)
+    if (state_dist[sq * 4 + side] < state_dist[best])
+      best = sq * 4 + side;
+  return best;
+}
+
+/** @brief Plans the room's fill order from step k on, the rocks already
+ *         placed being 'placed'
+ *  @return 1 if every remaining goal can be filled in the fewest pushes
+ */
+static int plan_room(unsigned int *placed, int k)
+{
+  // Not needed across the recursion, which mustn't use up the stack
+  static unsigned int reach[MAX_WORDS], blocked[MAX_WORDS];
+  int c, i, state, len;
+
+  if (k == room_size)
+    return 1;
+  if (++room_tries > MAX_ROOM_TRIES)
+    return 0;
+
+  for (c = 0; c < room_ngoals; c++) {
+    int g = room_goal[c];
+    if (BB_TEST(placed, g))
+      continue;
+    room_search(placed);
+    state = room_best(g);
+    len = state_dist[state];
+    if (len != room_lb[c] || room_start[k] + len > MAX_ROOM_PUSHES)
+      continue;
+
+    room_order[k] = g;
+    room_pusher[k] = neighbor[g][state & 3];
+    room_start[k + 1] = room_start[k] + len;
+    for (i = room_start[k + 1]; i > room_start[k]; state = state_prev[state]) {
+      int dir = (state & 3) ^ 2;
+      room_path[--i] = PUSH_CODE(neighbor[state >> 2][dir ^ 2], dir);
+    }
+
+    // The pusher has to be able to get back out
+    BB_SET(placed, g);
+    for (i = 0; i < nwords; i++)
+      blocked[i] = ~room_area[i] | placed[i];
+    flood(blocked, room_pusher[k], reach);
+    if (BB_TEST(reach, room_entrance) && plan_room(placed, k + 1))
+      return 1;
+    BB_CLEAR(placed, g);
+  }
+  return 0;
+}
+
+/** @brief Looks for a goal room and plans how to fill it
+ *
+ *  The room must hold at least two goals and, of the rocks, only ones on
+ *  its goals; its entrance must be a square with floor on just two
+ *  opposite sides, not a goal. With more goals than rocks, not every goal
+ *  in the room need be filled, so there's no room.
+ */
+static void find_room(const unsigned int *rocks, int pusher)
+{
+  unsigned int cut[MAX_WORDS], region[MAX_WORDS], placed[MAX_WORDS];
+  int e, d, i, c, n, in_room, best = 1;
+
+  room_entrance = NOT_FLOOR;
+  if (nrocks != ngoals)
+    return;
+  for (i = 0; i < nwords; i++)
+    cut[i] = 0;
+
+  for (e = 0; e < nfloor; e++) {
+    if (BB_TEST(goals, e) || BB_TEST(rocks, e) || e == pusher)
+      continue;
+    for (d = 0; d < 4; d++) {
+      if (neighbor[e][d] == NOT_FLOOR || neighbor[e][d ^ 2] == NOT_FLOOR ||
+          neighbor[e][d ^ 1] != NOT_FLOOR || neighbor[e][d ^ 3] != NOT_FLOOR)
+        continue;
+      BB_SET(cut, e);
+      flood(cut, neighbor[e][d], region);
+      BB_CLEAR(cut, e);
+      if (BB_TEST(region, neighbor[e][d ^ 2]) || BB_TEST(region, pusher))
+        continue;
+
+      in_room = 0;
+      for (i = 0; i < nfloor; i++) {
+        if (!BB_TEST(region, i))
+          continue;
+        if (BB_TEST(rocks, i) && !BB_TEST(goals, i))
+          break;
+        in_room += BB_TEST(goals, i);
+      }
+      if (i < nfloor || in_room <= best)
+        continue;
+
+      best = in_room;
+      room_entrance = e;
+      room_dir = d;
+      for (i = 0; i < nwords; i++)
+        room_mask[i] = room_area[i] = region[i];
+    }
+  }
+  if (room_entrance == NOT_FLOOR)
+    return;
+  BB_SET(room_area, room_entrance);
+  BB_SET(room_area, neighbor[room_entrance][room_dir ^ 2]);
+
+  // The fewest pushes into an empty room for each goal, farthest first
+  for (i = 0; i < nwords; i++)
+    placed[i] = 0;
+  room_search(placed);
+  room_ngoals = 0;
+  for (i = 0; i < nfloor; i++) {
+    if (!BB_TEST(room_mask, i) || !BB_TEST(goals, i))
+      continue;
+    n = state_dist[room_best(i)];
+    if (n == DEAD) {
+      room_entrance = NOT_FLOOR;
+      return;
+    }
+    for (c = room_ngoals++; c > 0 && room_lb[c - 1] < n; c--) {
+      room_goal[c] = room_goal[c - 1];
+      room_lb[c] = room_lb[c - 1];
+    }
+    room_goal[c] = i;
+    room_lb[c] = n;
+  }
+
+  for (i = 0; i < nwords; i++)
+    placed[i] = rocks[i] & room_mask[i];
+  room_placed = 0;
+  room_placed = room_rocks(placed);
+  room_size = room_ngoals - room_placed;
+  room_start[0] = 0;
+  room_tries = 0;
+  if (!plan_room(placed, 0))
+    room_entrance = NOT_FLOOR;
+}
+
+static int solved(const unsigned int *rocks)
+{
+  int i;
+
+  if (target != NOT_FLOOR)
+    return BB_TEST(rocks, target);
+  for (i = 0; i < nwords; i++)
+    if (rocks[i] & ~goals[i])
+      return 0;
+  return 1;
+}
+
+static unsigned int hash(const unsigned int *rocks, int pusher)
+{
+  unsigned int h = pusher * 0x9e3779b1u;
+  int i;
+
+  for (i = 0; i < nwords; i++) {
+    h = (h ^ rocks[i]) * 0x9e3779b1u;
+    h ^= h >> 15;
+  }
+  return h;
+}
+
+/** @brief Splits the caller's pool into the hash table and positions
+ *  @return 0 on success, or SOKO_NO_MEMORY if it's too small for any
+ */
+static int carve_pool(void *pool, unsigned int pool_size)
+{
+  unsigned int slots = 2, rec_bytes;
+  unsigned long base = ((unsigned long)pool + 3) & ~3ul;
+
+  if (pool == 0 || pool_size < base - (unsigned long)pool)
+    return SOKO_NO_MEMORY;
+  pool_size -= base - (unsigned long)pool;
+
+  // The largest table with room for half as many positions as slots
+  rec_words = REC_ROCKS + nwords;
+  rec_bytes = rec_words * sizeof(unsigned int);
+  if (slots * sizeof(unsigned int) + slots / 2 * rec_bytes > pool_size)
+    return SOKO_NO_MEMORY;
+  while (slots < 0x40000000u &&
+         2 * slots * sizeof(unsigned int) + slots * rec_bytes <= pool_size)
+    slots *= 2;
+
+  table = (unsigned int *)base;
+  table_mask = slots - 1;
+  positions = table + slots;
+  max_positions = (pool_size - slots * sizeof(unsigned int)) / rec_bytes;
+  if (max_positions > slots / 4 * 3)
+    max_positions = slots / 4 * 3;
+  return 0;
+}
+
+/** @brief Records a position unless it has been reached before in as few
+ *         pushes, and queues it with estimated cost f
+ *  @return 1 if it was queued, 0 if not, or SOKO_NO_MEMORY if the pool is
+ *          full
+ */
+static int remember(const unsigned int *rocks, int pusher, unsigned int parent,
+                    unsigned int push, unsigned int g, unsigned int f)
+{
+  unsigned int slot = hash(rocks, pusher) & table_mask;
+  unsigned int *rec, *old = 0;
+  int i;
+
+  for (; table[slot] != 0; slot = (slot + 1) & table_mask) {
+    rec = &positions[(table[slot] - 1) * rec_words];
+    if (INFO_PUSHER(rec[REC_INFO]) != pusher)
+      continue;
+    for (i = 0; i < nwords && rec[REC_ROCKS + i] == rocks[i]; i++)
+      continue;
+    if (i == nwords) {
+      old = rec;
+      break;
+    }
+  }
+
+  if (old != 0 && INFO_G(old[REC_INFO]) <= g)
+    return 0;
+  if (npositions == max_positions || f >= MAX_COST || g > MAX_G)
+    return SOKO_NO_MEMORY;
+
+  // A shorter way to an old position makes a new copy of it, and the old
+  // one is skipped when its turn comes
+  if (old != 0)
+    old[REC_PARENT] |= STALE;
+
+  rec = &positions[npositions * rec_words];
+  rec[REC_PARENT] = parent;
+  rec[REC_INFO] = INFO(pusher, push, g);
+  rec[REC_NEXT] = open[f];
+  for (i = 0; i < nwords; i++)
+    rec[REC_ROCKS + i] = rocks[i];
+  table[slot] = open[f] = ++npositions;
+  return 1;
+}
+
+/** @brief Lists the pushes of the step from position 'from' to 'to',
+ *         which start with the push 'push' and may be a macro
+ */
+static void trace_step(const unsigned int *from, const unsigned int *to,
+                       soko_push_t *pushes, int max_pushes)
+{
+  int sq = INFO_PUSH(to[REC_INFO]) >> 2, dir = INFO_PUSH(to[REC_INFO]) & 3;
+  int i = INFO_G(from[REC_INFO]), end = INFO_G(to[REC_INFO]), k, p;
+
+  while (i < end) {
+    if (room_entrance != NOT_FLOOR && sq == room_entrance && dir == room_dir) {
+      k = room_rocks(&from[REC_ROCKS]);
+      for (p = room_start[k]; p < room_start[k + 1]; p++, i++) {
+        if (i < max_pushes) {
+          pushes[i].x = cell_of[room_path[p] >> 2] % width;
+          pushes[i].y = cell_of[room_path[p] >> 2] / width;
+          pushes[i].dir = room_path[p] & 3;
+        }
+      }
+      return;
+    }
+    if (i < max_pushes) {
+      pushes[i].x = cell_of[sq] % width;
+      pushes[i].y = cell_of[sq] / width;
+      pushes[i].dir = dir;
+    }
+    sq = neighbor[sq][dir];
+    i++;
+  }
+}
+
+/** @brief Lists the pushes leading to position n, which is a solution
+ *  @return the number of pushes
+ */
+static int trace(unsigned int n, soko_push_t *pushes, int max_pushes)
+{
+  unsigned int *rec = &positions[n * rec_words], *parent;
+  int npushes = INFO_G(rec[REC_INFO]);
+
+  for (; (rec[REC_PARENT] & ~STALE) != NO_PARENT; rec = parent) {
+    parent = &positions[(rec[REC_PARENT] & ~STALE) * rec_words];
+    trace_step(parent, rec, pushes, max_pushes);
+  }
+  return npushes;
+}
+
+/** @brief Looks for a way to pull a rock off 'goal' onto one of the
+ *         squares in 'sources', the rock and the puller keeping off walls
+ *
+ *  Pulling is pushing backwards, so this finds whether a rock could be
+ *  pushed from a source to the goal.
+ *
+ *  @return 1 if there's a way, or 0
+ */
+static int pull_search(int goal, const unsigned int *walls,
+                       const unsigned int *sources)
+{
+  static unsigned int blocked[MAX_WORDS], around[MAX_WORDS];
+  int i, d, head, tail = 1;
+
+  for (i = 0; i < nfloor * 4; i++) {
+    state_dist[i] = DEAD;
+    state_done[i] = 0;
+  }
+  for (i = 0; i < nwords; i++)
+    blocked[i] = walls[i];
+  state_queue[0] = goal * 4;
+  state_dist[goal * 4] = 0;
+
+  for (head = 0; head < tail; head++) {
+    int state = state_queue[head], sq = state >> 2;
+
+    if (head == 0) {
+      // After the last push the pusher may be anywhere
+      for (i = 0; i < nwords; i++)
+        around[i] = ~walls[i];
+    } else {
+      BB_SET(blocked, sq);
+      flood(blocked, neighbor[sq][state & 3], around);
+      BB_CLEAR(blocked, sq);
+
+      // Sides the puller can walk between are all the same
+      for (d = 0; d < 4; d++)
+        if (neighbor[sq][d] != NOT_FLOOR &&
+            BB_TEST(around, neighbor[sq][d]) && state_done[sq * 4 + d])
+          break;
+      if (d < 4)
+        continue;
+      for (d = 0; d < 4; d++)
+        if (neighbor[sq][d] != NOT_FLOOR && BB_TEST(around, neighbor[sq][d]))
+          state_done[sq * 4 + d] = 1;
+    }
+
+    // The puller steps back from 'at' and the rock follows it there
+    for (d = 0; d < 4; d++) {
+      int at = neighbor[sq][d], back, next;
+
+      if (at == NOT_FLOOR || !BB_TEST(around, at))
+        continue;
+      back = neighbor[at][d];
+      if (back == NOT_FLOOR || BB_TEST(walls, back))
+        continue;
+      if (BB_TEST(sources, at))
+        return 1;
+      next = at * 4 + d;
+      if (state_dist[next] != DEAD)
+        continue;
+      state_dist[next] = state_dist[state] + 1;
+      state_queue[tail++] = next;
+    }
+  }
+  return 0;
+}
+
+/** @brief Works out an order to fill the empty goals in, for the rocks off
+ *         goals in 'rocks'
+ *
+ *  Works backwards from every goal filled: a goal can be the last filled
+ *  if its rock could be pulled off it to one of those rocks with only the
+ *  other goals' rocks in the way. Of the goals that can, the one nearest
+ *  the rocks is taken.
+ *
+ *  @return 1 if every empty goal has its place in pack_order, or 0
+ */
+static int plan_packing(const unsigned int *rocks)
+{
+  unsigned int filled[MAX_WORDS], loose[MAX_WORDS], done = 0, tried;
+  unsigned short near[SOKO_MAX_ROCKS];
+  int i, d, g, k, best;
+
+  pack_size = 0;
+  for (i = 0; i < nwords; i++) {
+    filled[i] = goals[i];
+    loose[i] = rocks[i] & ~goals[i];
+  }
+  for (g = 0; g < ngoals; g++) {
+    near[g] = DEAD;
+    if (BB_TEST(rocks, goal_sq[g])) {
+      done |= 1u << g;
+      continue;
+    }
+    pack_size++;
+    for (i = 0; i < nfloor; i++)
+      for (d = 0; d < 4 && BB_TEST(loose, i); d++)
+        if (goal_dist[g][i][d] < near[g])
+          near[g] = goal_dist[g][i][d];
+  }
+
+  for (k = pack_size; k > 0; k--) {
+    for (tried = done;; tried |= 1u << best) {
+      best = -1;
+      for (g = 0; g < ngoals; g++)
+        if (!(tried >> g & 1) && (best < 0 || near[g] < near[best]))
+          best = g;
+      if (best < 0)
+        return 0;
+      BB_CLEAR(filled, goal_sq[best]);
+      if (pull_search(goal_sq[best], filled, loose))
+        break;
+      BB_SET(filled, goal_sq[best]);
+    }
+    done |= 1u << best;
+    pack_order[k - 1] = goal_sq[best];
+  }
+  return 1;
+}
+
+/** @brief Searches from the position with rocks 'start' and the pusher on
+ *         *at for a solution with the fewest pushes
+ *
+ *  If there's a target goal, a solution need only fill it.
+ *
+ *  @return the number of pushes in the solution, having left the position
+ *          it reaches in start and *at, or SOKO_UNSOLVABLE or SOKO_NO_MEMORY
+ */
+static int search(unsigned int *start, int *at, soko_push_t *pushes,
+                  int max_pushes)
+{
+  unsigned int rocks[MAX_WORDS], next[MAX_WORDS], reach[MAX_WORDS];
+  unsigned int n, f, g, next_f, *rec;
+  int result, i, d, h, row, pusher;
+
+  npositions = 0;
+  work = 0;
+  for (n = 0; n <= table_mask; n++)
+    table[n] = 0;
+  for (f = 0; f < MAX_COST; f++)
+    open[f] = 0;
+
+  for (i = 0; i < nwords; i++)
+    rocks[i] = start[i];
+  pusher = flood(rocks, *at, reach);
+  if ((h = estimate(rocks, reach)) >= NO_MATCH)
+    return SOKO_UNSOLVABLE;
+  f = h;
+  result = remember(rocks, pusher, NO_PARENT, 0, 0, f);
+  if (result < 0)
+    return result;
+
+  // Expand positions in order of estimated cost. The estimate isn't
+  // consistent: pair_cost() depends on where the pusher can walk, so a push
+  // can lower it by more than the push costs. A child whose cost comes out
+  // below its parent's takes the parent's instead (pathmax), which keeps
+  // the estimate admissible along the path, so the scan never has to go
+  // back and no child is lost.
+  for (; f < MAX_COST; f++) {
+    while (open[f] != 0) {
+      int in_room;
+
+      n = open[f] - 1;
+      rec = &positions[n * rec_words];
+      open[f] = rec[REC_NEXT];
+      if (rec[REC_PARENT] & STALE)
+        continue;
+      if (work > MAX_WORK)
+        return SOKO_NO_MEMORY;
+      g = INFO_G(rec[REC_INFO]);
+
+      for (i = 0; i < nwords; i++)
+        rocks[i] = next[i] = rec[REC_ROCKS + i];
+      if (solved(rocks)) {
+        for (i = 0; i < nwords; i++)
+          start[i] = rocks[i];
+        *at = INFO_PUSHER(rec[REC_INFO]);
+        return trace(n, pushes, max_pushes);
+      }
+      flood(rocks, INFO_PUSHER(rec[REC_INFO]), reach);
+      estimate(rocks, reach);
+      in_room = room_entrance != NOT_FLOOR ? room_rocks(rocks) : 0;
+      next_f = MAX_COST;
+
+      for (row = 1; row <= nrocks; row++) {
+        int sq = row_sq[row];
+
+        // Rocks in the goal room have been put where they belong, as have
+        // those placed filling goals one at a time
+        if ((room_entrance != NOT_FLOOR && BB_TEST(room_mask, sq)) ||
+            BB_TEST(placed, sq))
+          continue;
+
+        for (d = 0; d < 4; d++) {
+          int to = neighbor[sq][d], from = neighbor[sq][d ^ 2];
+          int pusher = sq, npushes = 1, normal;
+          unsigned int reach_after[MAX_WORDS], fc;
+
+          if (to == NOT_FLOOR || from == NOT_FLOOR || !BB_TEST(reach, from) ||
+              BB_TEST(rocks, to) || dist[to] == DEAD ||
+              (room_entrance != NOT_FLOOR && BB_TEST(room_mask, to)))
+            continue;
+
+          // Macros: into the goal room, or on through a tunnel
+          for (;;) {
+            if (room_entrance != NOT_FLOOR && to == room_entrance &&
+                d == room_dir && in_room < room_size) {
+              npushes += room_start[in_room + 1] - room_start[in_room];
+              pusher = room_pusher[in_room];
+              to = room_order[in_room];
+              break;
+            }
+            if (BB_TEST(goals, to) || !tunnel(to, d) || !tunnel(pusher, d))
+              break;
+            i = neighbor[to][d];
+            if (i == NOT_FLOOR || BB_TEST(rocks, i) || dist[i] == DEAD ||
+                (room_entrance != NOT_FLOOR && BB_TEST(room_mask, i)))
+              break;
+            pusher = to;
+            to = i;
+            npushes++;
+          }
+
+          BB_CLEAR(next, sq);
+          BB_SET(next, to);
+          if (!freeze_deadlock(next, to)) {
+            normal = flood(next, pusher, reach_after);
+            h = estimate_moved(row, to, reach_after);
+            fc = g + npushes + h;
+            if (fc < f)
+              fc = f;
+            if (h < NO_MATCH && fc == f &&
+                !corral_deadlock(next, reach_after, to)) {
+              result = remember(next, normal, n, PUSH_CODE(sq, d),
+                                g + npushes, fc);
+              if (result < 0)
+                return result;
+            } else if (h < NO_MATCH && fc > f && fc < next_f) {
+              next_f = fc;
+            }
+          }
+          BB_CLEAR(next, to);
+          BB_SET(next, sq);
+        }
+      }
+
+      // Come back for the children held back
+      if (next_f < MAX_COST) {
+        rec[REC_NEXT] = open[next_f];
+        open[next_f] = n + 1;
+      }
+    }
+  }
+  return SOKO_UNSOLVABLE;
+}
+
+/** @brief Finds a solution of a level, with as few pushes as possible if
+ *         that doesn't take too long
+ *
+ *  The level may be a position part way through a game, to produce a
+ *  hint: the first push of the solution. pool and pool_size give the memory
+ *  the search may use. If it fills up, or the search goes on too long,
+ *  before the fewest pushes are found, the goals are instead filled a rock
+ *  at a time in an order that leaves a way to the rest.
+ *
+ *  @param pushes where the solution goes; if it is longer than max_pushes,
+ *         only its first max_pushes pushes are stored
+ *  @return the number of pushes in the solution, or SOKO_UNSOLVABLE,
+ *          SOKO_NO_MEMORY if no solution was found within those limits,
+ *          or SOKO_BAD_LEVEL if the level can't be read
+ */
+int soko_solve(const sokolevel_t *level, void *pool, unsigned int pool_size,
+               soko_push_t *pushes, int max_pushes)
+{
+  unsigned int rocks[MAX_WORDS];
+  int start, result, i, k, done, excess = 0;
+
+  if ((result = read_level(level, rocks, &start)) < 0)
+    return result;
+  if ((result = carve_pool(pool, pool_size)) < 0)
+    return result;
+  find_sides();
+  find_distances();
+
+  for (i = 0; i < nfloor; i++) {
+    excess += BB_TEST(rocks, i) - BB_TEST(goals, i);
+    if (BB_TEST(rocks, i) && dist[i] == DEAD)
+      return SOKO_UNSOLVABLE;
+  }
+  if (excess > 0)
+    return SOKO_UNSOLVABLE;
+
+  start = floor_of[start];
+  find_room(rocks, start);
+
+  target = NOT_FLOOR;
+  for (i = 0; i < nwords; i++)
+    placed[i] = 0;
+  result = search(rocks, &start, pushes, max_pushes);
+  if (result != SOKO_NO_MEMORY || nrocks != ngoals || !plan_packing(rocks))
+    return result;
+
+  // Fill the goals one at a time, each as soon as possible
+  room_entrance = NOT_FLOOR;
+  for (i = 0; i < nwords; i++)
+    placed[i] = rocks[i] & goals[i];
+  for (k = 0, done = 0; k < pack_size; k++, done += result) {
+    target = pack_order[k];
+    for (target_col = 1; goal_sq[target_col - 1] != target; target_col++)
+      continue;
+    result = search(rocks, &start, done < max_pushes ? pushes + done : pushes,
+                    max_pushes - done);
+    if (result < 0)
+      return result;
+    BB_SET(placed, target);
+  }
+  return done;
+}
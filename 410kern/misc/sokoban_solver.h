@@ -0,0 +1,35 @@
+/** @file sokoban_solver.h
+ *  @brief Interface to the sokoban solver
+ */
+
+#ifndef _SOKOBAN_SOLVER_H_
+#define _SOKOBAN_SOLVER_H_
+
+#include "sokoban.h"
+
+// Largest level (width * height) the solver handles
+#define SOKO_MAX_CELLS 1024
+
+// Most cells the pusher can reach in a level the solver handles
+#define SOKO_MAX_FLOOR 512
+
+// Most rocks, and most goals, in a level the solver handles
+#define SOKO_MAX_ROCKS 32
+
+// Failures of soko_solve()
+#define SOKO_UNSOLVABLE (-1)
+#define SOKO_NO_MEMORY  (-2)
+#define SOKO_BAD_LEVEL  (-3)
+
+// One push: the rock at (x, y) moves one square in direction dir (SOKO_UP
+// and friends)
+typedef struct soko_push {
+  unsigned char x;
+  unsigned char y;
+  unsigned char dir;
+} soko_push_t;
+
+int soko_solve(const sokolevel_t *level, void *pool, unsigned int pool_size,
+               soko_push_t *pushes, int max_pushes);
+
+#endif /* _SOKOBAN_SOLVER_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @brief Build-time packer for the sudoku database
+ *
+ * This is a host program, linked against sudokudb.c, which prints the
+ * database as the C source of the tables described in sudokupack.h: the
+ * puzzles are grouped by difficulty (keeping their order within a
+ * difficulty) and each is stored as SU_PACKED_SIZE bytes, two cells per byte
+ * with the even cell in the low nibble.
+ *
+ * It exits with a nonzero status, and prints nothing useful, if the text
+ * database is malformed, so a bad database fails the build rather than
+ * producing puzzles that decode as garbage.
+ */
+
+#include <stdio.h>
+#include "sudoku.h"
+#include "sudokudb.h"
+#include "sudokupack.h"
+
+#define RECORD_LEN (1 + SU_GRID_AREA)
+
+static int bad(int n, const char *why) {
+  printf("#error \"sudokudb puzzle %d: %s\"\n", n, why);
+  return 1;
+}
+
+int main(void) {
+  int counts[MAX_DIFFICULTY];
+  int npuzzles, d, n, i, start;
+  const char *p;
+
+  for (d = 0; d < MAX_DIFFICULTY; d++)
+    counts[d] = 0;
+
+  /* Validate and count the puzzles of each difficulty */
+  for (npuzzles = 0, p = sudokudb; *p; npuzzles++, p += RECORD_LEN) {
+    if (npuzzles == MAX_SUDOKUS)
+      return bad(npuzzles, "more than MAX_SUDOKUS puzzles");
+    if (p[0] < '0' || p[0] >= '0' + MAX_DIFFICULTY)
+      return bad(npuzzles, "bad difficulty");
+    for (i = 1; i < RECORD_LEN; i++) {
+      if (p[i] == '\0')
+        return bad(npuzzles, "truncated");
+      if (p[i] != ' ' && (p[i] < '1' || p[i] > '0' + SU_GRID_SIZE))
+        return bad(npuzzles, "bad cell");
+    }
+    counts[p[0] - '0']++;
+  }
+
+  printf("/* Generated from sudokudb.c by sudokudb_pack; do not edit. */\n\n");
+  printf("#include \"sudokupack.h\"\n\n");
+
+  printf("const unsigned short sudokudb_buckets[MAX_DIFFICULTY + 1] = {\n");
+  for (d = 0, start = 0; d <= MAX_DIFFICULTY; d++) {
+    printf("  %d,\n", start);
+    if (d < MAX_DIFFICULTY)
+      start += counts[d];
+  }
+  printf("};\n\n");
+
+  printf("const unsigned char sudokudb_packed[%d * SU_PACKED_SIZE] = {\n",
+         npuzzles > 0 ? npuzzles : 1);
+  for (d = 0; d < MAX_DIFFICULTY; d++) {
+    for (n = 0, p = sudokudb; n < npuzzles; n++, p += RECORD_LEN) {
+      if (p[0] != '0' + d)
+        continue;
+      printf(" ");
+      for (i = 0; i < SU_GRID_AREA; i += 2) {
+        int lo = p[1 + i] == ' ' ? 0 : p[1 + i] - '0';
+        int hi = 0;
+        if (i + 1 < SU_GRID_AREA && p[2 + i] != ' ')
+          hi = p[2 + i] - '0';
+        printf(" 0x%02x,", hi << 4 | lo);
+      }
+      printf("\n");
+    }
+  }
+  printf("};\n");
+  return 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file sudokugen.c
+ * @brief Generates random sudokus with one solution and a chosen difficulty
+ *
+ * A random full grid is made by filling the three boxes on the diagonal,
+ * which don't constrain each other, with random permutations, and letting
+ * the search solver complete the rest. Its cells are then removed in a
+ * random order, each removal kept only if the puzzle still has exactly one
+ * solution and isn't harder than wanted. What remains has a unique solution
+ * and can lose no more cells. If it isn't as hard as wanted, clues are
+ * swapped for other cells of the solution while that makes it no easier
+ * (see climb()), and failing that another grid is tried.
+ *
+ * Every puzzle is checked with su_rate(), which searches for a second
+ * solution, and the caller bounds the number of such checks, so generation
+ * takes bounded time however unlucky the random numbers are. The random
+ * numbers come from genrand(), so the caller seeds it.
+ */
+
+#include <stdint.h>
+#include <mt19937int.h>
+#include "sudokugen.h"
+#include "searchsolver.h"
+#include "sudokudb.h"
+
+/* Checks without progress spent on one grid before trying a new one */
+#define CLIMB_STEPS 500
+
+/**
+ * @brief Returns a random number in [0, n), each exactly as likely
+ *
+ * As pcg32_bounded() does, this takes the high word of a 32-bit random
+ * number times n, redrawing the few low words below 2^32 mod n that would
+ * make some results likelier than others.
+ */
+static int random_below(int n) {
+  uint32_t bound = n, threshold;
+  uint64_t m = (uint64_t)(uint32_t)genrand() * bound;
+
+  if ((uint32_t)m < bound) {
+    threshold = -bound % bound;
+    while ((uint32_t)m < threshold)
+      m = (uint64_t)(uint32_t)genrand() * bound;
+  }
+  return m >> 32;
+}
+
+/** @brief Shuffles a[0..n) */
+static void shuffle(unsigned char *a, int n) {
+  int i, j;
+  unsigned char t;
+
+  for (i = n - 1; i > 0; i--) {
+    j = random_below(i + 1);
+    t = a[i];
+    a[i] = a[j];
+    a[j] = t;
+  }
+}
+
+/** @brief Fills 'grid' with a random solved sudoku */
+static void random_grid(sudoku_t grid) {
+  unsigned char digits[SU_GRID_SIZE];
+  int box, row, col, i;
+
+  for (row = 0; row < SU_GRID_SIZE; row++)
+    for (col = 0; col < SU_GRID_SIZE; col++)
+      grid[row][col] = 0;
+
+  for (box = 0; box < SU_BOX_SIZE; box++) {
+    for (i = 0; i < SU_GRID_SIZE; i++)
+      digits[i] = i + 1;
+    shuffle(digits, SU_GRID_SIZE);
+    for (i = 0; i < SU_GRID_SIZE; i++)
+      grid[box * SU_BOX_SIZE + i / SU_BOX_SIZE]
+          [box * SU_BOX_SIZE + i % SU_BOX_SIZE] = digits[i];
+  }
+
+  /* Any filling of the diagonal boxes can be completed */
+  searchsolve(grid);
+}
+
+/**
+ * @brief Returns the index of a random cell of 'puzzle' which is (or isn't)
+ *        filled in
+ *
+ * 'count' is how many such cells there are, and must not be 0.
+ */
+static int random_cell(sudoku_t puzzle, int filled, int count) {
+  int cell, n = random_below(count);
+
+  for (cell = 0; ; cell++)
+    if ((puzzle[cell / SU_GRID_SIZE][cell % SU_GRID_SIZE] != 0) == filled &&
+        n-- == 0)
+      return cell;
+}
+
+/**
+ * @brief Makes a minimal puzzle harder until it rates 'difficulty'
+ *
+ * Digging stops at a puzzle where every clue is needed, which is seldom
+ * one the search solver has to guess much on: a random grid almost never
+ * digs down past 32 guesses (level 7). So each step swaps a clue for a
+ * cell of the solution, keeping the swap if the puzzle still has one
+ * solution and takes at least as many guesses, but isn't harder than
+ * wanted. Such a climb gets stuck on some grids, so it gives up after
+ * CLIMB_STEPS checks in a row fail to add a guess, and the caller starts on
+ * a new grid.
+ *
+ * @param puzzle a minimal puzzle, which is left as the hardest one found
+ * @param solution its solution
+ * @param budget checks left, which is decremented for each one made here
+ * @return 1 if 'puzzle' now rates 'difficulty', else 0
+ */
+static int climb(sudoku_t puzzle, sudoku_t solution, int difficulty,
+                 unsigned int *budget) {
+  su_effort_t effort;
+  unsigned int guesses;
+  int clues, step, add, del, level;
+
+  clues = 0;
+  for (add = 0; add < SU_GRID_AREA; add++)
+    clues += puzzle[add / SU_GRID_SIZE][add % SU_GRID_SIZE] != 0;
+
+  su_rate(puzzle, &effort);
+  guesses = effort.guesses;
+  if (su_difficulty(&effort) == difficulty)
+    return 1;
+
+  for (step = 0; step < CLIMB_STEPS && *budget > 0; step++, (*budget)--) {
+    add = random_cell(puzzle, 0, SU_GRID_AREA - clues);
+    del = random_cell(puzzle, 1, clues);
+    puzzle[add / SU_GRID_SIZE][add % SU_GRID_SIZE] =
+      solution[add / SU_GRID_SIZE][add % SU_GRID_SIZE];
+    puzzle[del / SU_GRID_SIZE][del % SU_GRID_SIZE] = 0;
+
+    if (su_rate(puzzle, &effort) == 1 && effort.guesses >= guesses &&
+        (level = su_difficulty(&effort)) <= difficulty) {
+      if (effort.guesses > guesses)
+        step = 0;
+      guesses = effort.guesses;
+      if (level == difficulty)
+        return 1;
+    } else {
+      puzzle[del / SU_GRID_SIZE][del % SU_GRID_SIZE] =
+        solution[del / SU_GRID_SIZE][del % SU_GRID_SIZE];
+      puzzle[add / SU_GRID_SIZE][add % SU_GRID_SIZE] = 0;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Generates a sudoku with exactly one solution
+ *
+ * @param difficulty as rated by su_difficulty(), 0 to MAX_DIFFICULTY - 1
+ * @param budget the most puzzles to check for uniqueness; each check is one
+ *        run of the search solver. A grid takes SU_GRID_AREA checks to dig,
+ *        then at least CLIMB_STEPS more to climb unless digging alone gives
+ *        the difficulty; levels 8 and 9 take thousands of checks, and about
+ *        a fifth of level 9 puzzles need over 100000.
+ * @return 0 on success, or -1 if the budget ran out first
+ */
+int su_generate(sudoku_t puzzle, int difficulty, unsigned int budget) {
+  unsigned char order[SU_GRID_AREA];
+  sudoku_t solution;
+  su_effort_t effort;
+  int i, row, col, digit;
+
+  if (difficulty < 0 || difficulty >= MAX_DIFFICULTY)
+    return -1;
+
+  while (budget > 0) {
+    random_grid(puzzle);
+    for (i = 0; i < SU_GRID_AREA; i++) {
+      order[i] = i;
+      solution[i / SU_GRID_SIZE][i % SU_GRID_SIZE] =
+        puzzle[i / SU_GRID_SIZE][i % SU_GRID_SIZE];
+    }
+    shuffle(order, SU_GRID_AREA);
+
+    for (i = 0; i < SU_GRID_AREA && budget > 0; i++, budget--) {
+      row = order[i] / SU_GRID_SIZE;
+      col = order[i] % SU_GRID_SIZE;
+      digit = puzzle[row][col];
+      puzzle[row][col] = 0;
+      if (su_rate(puzzle, &effort) != 1 || su_difficulty(&effort) > difficulty)
+        puzzle[row][col] = digit;
+    }
+
+    if (i == SU_GRID_AREA && climb(puzzle, solution, difficulty, &budget))
+      return 0;
+  }
+  return -1;
+}
@@ -0,0 +1,13 @@
+/**
+ * @file sudokugen.h
+ * @brief Random sudoku generation
+ */
+
+#ifndef _SUDOKUGEN_H
+#define _SUDOKUGEN_H
+
+#include "sudoku.h"
+
+int su_generate(sudoku_t puzzle, int difficulty, unsigned int budget);
+
+#endif /* _SUDOKUGEN_H */
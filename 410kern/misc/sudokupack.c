@@ -0,0 +1,38 @@
+/**
+ * @brief Constant time access to the packed sudoku database
+ */
+
+#include "sudokupack.h"
+
+/**
+ * @brief Returns the number of puzzles of the given difficulty
+ */
+int sudoku_count(int difficulty) {
+  if (difficulty < 0 || difficulty >= MAX_DIFFICULTY)
+    return 0;
+  return sudokudb_buckets[difficulty + 1] - sudokudb_buckets[difficulty];
+}
+
+/**
+ * @brief Copies out the nth puzzle (counting from 0) of a difficulty
+ *
+ * @return 0 on success, or -1 if there is no such puzzle
+ */
+int sudoku_get(int difficulty, int n, sudoku_t out) {
+  const unsigned char *packed;
+  char *cell = &out[0][0];
+  int i;
+
+  if (n < 0 || n >= sudoku_count(difficulty))
+    return -1;
+
+  packed = &sudokudb_packed[(sudokudb_buckets[difficulty] + n) *
+                            SU_PACKED_SIZE];
+  for (i = 0; i < SU_GRID_AREA - 1; i += 2, packed++) {
+    cell[i] = *packed & 0xf;
+    cell[i + 1] = *packed >> 4;
+  }
+  if (SU_GRID_AREA % 2)
+    cell[i] = *packed & 0xf;
+  return 0;
+}
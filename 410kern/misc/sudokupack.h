@@ -0,0 +1,32 @@
+/**
+ * @file sudokupack.h
+ * @brief Indexed, packed binary form of the sudoku "database"
+ *
+ * The tables are generated from sudokudb at build time by sudokudb_pack (see
+ * misc/kernel.mk). A game using them lists misc/sudokudb_packed.o and
+ * misc/sudokupack.o in 410_GAME_OBJS instead of misc/sudokudb.o.
+ */
+
+#ifndef _SUDOKUPACK_H
+#define _SUDOKUPACK_H
+
+#include "sudoku.h"
+#include "sudokudb.h"
+
+/* Bytes per packed puzzle: one 4-bit cell per nibble */
+#define SU_PACKED_SIZE ((SU_GRID_AREA + 1) / 2)
+
+/*
+ * The puzzles of difficulty d are numbers sudokudb_buckets[d] through
+ * sudokudb_buckets[d + 1] - 1, and puzzle i is stored at
+ * &sudokudb_packed[i * SU_PACKED_SIZE]. Cell k of a puzzle (in row-major
+ * order) is in the low nibble of byte k / 2 if k is even and the high nibble
+ * otherwise; a 0 nibble is a blank cell.
+ */
+extern const unsigned short sudokudb_buckets[MAX_DIFFICULTY + 1];
+extern const unsigned char sudokudb_packed[];
+
+int sudoku_count(int difficulty);
+int sudoku_get(int difficulty, int n, sudoku_t out);
+
+#endif /* _SUDOKUPACK_H */
@@ -0,0 +1,119 @@
+/**
+ * @file texttwist_dawg.c
+ * @brief Lookups in the TextTwist word graph
+ */
+
+#include <string.h>
+#include "texttwist_dawg.h"
+
+/** State of a search for the words in a rack */
+typedef struct tt_dawg_search {
+  unsigned char counts[26];  /* letters of the rack not yet used */
+  char word[TT_MAX_WORD + 1];
+  char (*words)[TT_MAX_WORD + 1];
+  int max_words;
+  int found;
+} tt_dawg_search_t;
+
+/**
+ * @brief Follows a string of lowercase letters from the root
+ *
+ * @return the last edge taken (TT_DAWG_END is set in it if the string is a
+ *         word), 0 for the empty string, or -1 if no word starts with the
+ *         string
+ */
+static int follow(const char *s) {
+  unsigned int node = TT_DAWG_ROOT, edge = 0;
+  int c;
+
+  for (; *s != '\0'; s++) {
+    if (node == 0 || *s < 'a' || *s > 'z')
+      return -1;
+    c = *s - 'a';
+    for (edge = tt_dawg[node]; TT_DAWG_LETTER(edge) < c; edge = tt_dawg[++node])
+      if (edge & TT_DAWG_LAST)
+        return -1;
+    if (TT_DAWG_LETTER(edge) != c)
+      return -1;
+    node = TT_DAWG_CHILD(edge);
+  }
+  return edge;
+}
+
+/**
+ * @brief Checks whether a string is a word of the dictionary
+ *
+ * @return 1 if it is, 0 if not
+ */
+int tt_dawg_is_word(const char *word) {
+  int edge = follow(word);
+
+  return edge > 0 && (edge & TT_DAWG_END) != 0;
+}
+
+/**
+ * @brief Checks whether any word of the dictionary starts with a string
+ *
+ * @return 1 if one does (the string itself counts), 0 if not
+ */
+int tt_dawg_is_prefix(const char *prefix) {
+  return follow(prefix) >= 0;
+}
+
+/** @brief Lists the words that go on from s->word[0..len) through node */
+static void search(tt_dawg_search_t *s, unsigned int node, int len) {
+  unsigned int edge;
+  int c;
+
+  do {
+    edge = tt_dawg[node++];
+    c = TT_DAWG_LETTER(edge);
+    if (s->counts[c] == 0)
+      continue;
+
+    s->word[len] = 'a' + c;
+    if ((edge & TT_DAWG_END) && len + 1 >= TT_MIN_WORD) {
+      if (s->found < s->max_words) {
+        s->word[len + 1] = '\0';
+        memcpy(s->words[s->found], s->word, len + 2);
+      }
+      s->found++;
+    }
+    if (TT_DAWG_CHILD(edge) != 0 && len + 1 < TT_MAX_WORD) {
+      s->counts[c]--;
+      search(s, TT_DAWG_CHILD(edge), len + 1);
+      s->counts[c]++;
+    }
+  } while (!(edge & TT_DAWG_LAST));
+}
+
+/**
+ * @brief Finds every word that can be made from some of the letters of a
+ *        rack, each letter used at most as often as it appears in the rack
+ *
+ * The words come in alphabetical order.
+ *
+ * @param rack lowercase letters
+ * @param words where the words go, NUL-terminated; only the first max_words
+ *        are stored
+ * @return the number of words found, or -1 if the rack is bad
+ */
+int tt_dawg_rack_words(const char *rack, char (*words)[TT_MAX_WORD + 1],
+                       int max_words) {
+  tt_dawg_search_t s;
+  int c;
+
+  for (c = 0; c < 26; c++)
+    s.counts[c] = 0;
+  for (; *rack != '\0'; rack++) {
+    if (*rack < 'a' || *rack > 'z' || s.counts[*rack - 'a'] == 255)
+      return -1;
+    s.counts[*rack - 'a']++;
+  }
+  s.words = words;
+  s.max_words = max_words;
+  s.found = 0;
+
+  search(&s, TT_DAWG_ROOT, 0);
+  return s.found;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file texttwist_dawg.h
+ * @brief The TextTwist dictionary as a directed acyclic word graph
+ *
+ * A trie of the dictionary in which identical subtrees are stored only once,
+ * generated from texttwist_dict at build time by texttwist_pack (see
+ * misc/kernel.mk). It is much smaller than the text, and finding a word
+ * takes one step per letter. A game using it lists misc/texttwist_packed.o
+ * and misc/texttwist_dawg.o in 410_GAME_OBJS, and can then leave out
+ * misc/texttwist_dict.o.
+ */
+
+#ifndef _TEXTTWIST_DAWG_H_
+#define _TEXTTWIST_DAWG_H_
+
+#include "texttwist_dict.h"
+
+/*
+ * Each node of the graph is a run of edges in tt_dawg[], in alphabetical
+ * order, the last marked with TT_DAWG_LAST. An edge holds its letter (0 for
+ * 'a'), whether the letters leading to and along it spell a word, and the
+ * index in tt_dawg[] of the node it leads to, or 0 if it leads nowhere. The
+ * root node starts at TT_DAWG_ROOT.
+ */
+#define TT_DAWG_LETTER(edge) ((edge) & 0x1f)
+#define TT_DAWG_END          0x20
+#define TT_DAWG_LAST         0x40
+#define TT_DAWG_CHILD(edge)  ((edge) >> 8)
+
+#define TT_DAWG_ROOT 1
+
+extern const unsigned int tt_dawg[];
+extern const unsigned int tt_dawg_edges;
+
+int tt_dawg_is_word(const char *word);
+int tt_dawg_is_prefix(const char *prefix);
+int tt_dawg_rack_words(const char *rack, char (*words)[TT_MAX_WORD + 1],
+                       int max_words);
+
+#endif /* _TEXTTWIST_DAWG_H_ */
@@ -7,6 +7,10 @@
 #ifndef _TEXTTWIST_DICT_H_
 #define _TEXTTWIST_DICT_H_
 
+/* Shortest and longest words in the dictionary */
+#define TT_MIN_WORD 2
+#define TT_MAX_WORD 6
+
 extern char texttwist_dict[];
 
 #endif /* _TEXTTWIST_DICT_H_ */
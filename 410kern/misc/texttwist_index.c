@@ -0,0 +1,205 @@
+/**
+ * @file texttwist_index.c
+ * @brief An anagram index over the TextTwist dictionary
+ */
+
+#include <types.h>
+#include <string.h>
+#include <stdlib/sortgen.h>
+#include "texttwist_index.h"
+
+/** A word's letters in alphabetical order, 5 bits each, the first in the
+ *  highest bits. With its length, this says how many of each letter the
+ *  word has, so words with the same key are anagrams of each other. */
+typedef unsigned int tt_key_t;
+
+typedef struct tt_entry {
+  tt_key_t key;
+  unsigned short offset;  /* of the word in texttwist_dict */
+  unsigned char len;
+} tt_entry_t;
+
+/** Orders entries by length, then key, then place in the dictionary,
+ *  which is alphabetical */
+#define ENTRY_LESS(x, y)                                               \
+  ((x)->len != (y)->len ? (x)->len < (y)->len :                        \
+   (x)->key != (y)->key ? (x)->key < (y)->key : (x)->offset < (y)->offset)
+
+SORTGEN_DEFINE(static, entry_sort, tt_entry_t, ENTRY_LESS)
+
+static tt_entry_t entries[TT_INDEX_WORDS];
+
+/** The words of length n are entries[group[n]] to entries[group[n + 1] - 1] */
+static int group[TT_MAX_WORD + 2];
+
+/** State of a search for the words in a rack */
+typedef struct tt_search {
+  char rack[TT_MAX_RACK];
+  int nrack;
+  tt_word_t *words;
+  int max_words;
+  int found;
+} tt_search_t;
+
+/**
+ * @brief Copies a string of lowercase letters and sorts the copy
+ *
+ * @return the number of letters, or -1 if there are more than max or
+ *         something else is in the string
+ */
+static int sorted_letters(const char *s, int max, char *letters) {
+  int n, i;
+  char c;
+
+  for (n = 0; s[n] != '\0'; n++) {
+    if (n == max || s[n] < 'a' || s[n] > 'z')
+      return -1;
+    c = s[n];
+    for (i = n; i > 0 && letters[i - 1] > c; i--)
+      letters[i] = letters[i - 1];
+    letters[i] = c;
+  }
+  return n;
+}
+
+/** @brief Finds the first entry of length len with a key >= key */
+static int lower_bound(int len, tt_key_t key) {
+  int lo = group[len], hi = group[len + 1], mid;
+
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (entries[mid].key < key)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * @brief Builds the index
+ *
+ * Call once, before any other tt_ function. Sorting the dictionary takes a
+ * few milliseconds.
+ *
+ * @return the number of words indexed, or -1 if texttwist_dict holds too
+ *         many or has a word that isn't 2 to 6 lowercase letters
+ */
+int tt_index_init(void) {
+  const char *p = texttwist_dict;
+  char letters[TT_MAX_WORD + 1];
+  tt_key_t key;
+  int n = 0, len, i;
+
+  memset(group, 0, sizeof(group));
+
+  while (*p != '\0') {
+    if (*p == ' ') {
+      p++;
+      continue;
+    }
+    for (len = 0; p[len] != ' ' && p[len] != '\0'; len++)
+      if (len < TT_MAX_WORD)
+        letters[len] = p[len];
+    if (len < TT_MIN_WORD || len > TT_MAX_WORD || n == TT_INDEX_WORDS ||
+        p - texttwist_dict > 0xffff)
+      return -1;
+    letters[len] = '\0';
+    if (sorted_letters(letters, TT_MAX_WORD, letters) < 0)
+      return -1;
+
+    for (key = 0, i = 0; i < len; i++)
+      key = key << 5 | (letters[i] - 'a');
+    entries[n].key = key;
+    entries[n].offset = p - texttwist_dict;
+    entries[n].len = len;
+    n++;
+    p += len;
+  }
+
+  entry_sort(entries, n);
+  for (len = TT_MIN_WORD, i = 0; len <= TT_MAX_WORD + 1; len++) {
+    while (i < n && entries[i].len < len)
+      i++;
+    group[len] = i;
+  }
+  return n;
+}
+
+/**
+ * @brief Checks whether a string is a word of the dictionary
+ *
+ * @return 1 if it is, 0 if not
+ */
+int tt_is_word(const char *word) {
+  char letters[TT_MAX_WORD];
+  tt_key_t key = 0;
+  int len, i;
+
+  len = sorted_letters(word, TT_MAX_WORD, letters);
+  if (len < TT_MIN_WORD)
+    return 0;
+  for (i = 0; i < len; i++)
+    key = key << 5 | (letters[i] - 'a');
+
+  for (i = lower_bound(len, key); i < group[len + 1] && entries[i].key == key;
+       i++)
+    if (memcmp(texttwist_dict + entries[i].offset, word, len) == 0)
+      return 1;
+  return 0;
+}
+
+/**
+ * @brief Lists the words with the key made of 'left' more letters from
+ *        s->rack[start] on, after those in 'key' already
+ *
+ * Choices are made in rack order and a letter is never chosen in place of
+ * an equal one just passed over, so each key is made once, and in
+ * increasing order.
+ */
+static void choose(tt_search_t *s, int start, int left, int len,
+                   tt_key_t key) {
+  int i;
+
+  if (left == 0) {
+    for (i = lower_bound(len, key);
+         i < group[len + 1] && entries[i].key == key; i++, s->found++) {
+      if (s->found < s->max_words) {
+        s->words[s->found].text = texttwist_dict + entries[i].offset;
+        s->words[s->found].len = len;
+      }
+    }
+    return;
+  }
+
+  for (i = start; i <= s->nrack - left; i++)
+    if (i == start || s->rack[i] != s->rack[i - 1])
+      choose(s, i + 1, left - 1, len, key << 5 | (s->rack[i] - 'a'));
+}
+
+/**
+ * @brief Finds every word that can be made from some of the letters of a
+ *        rack, each letter used at most as often as it appears in the rack
+ *
+ * The words come shortest first, and in alphabetical order of their
+ * letters within a length.
+ *
+ * @param rack up to TT_MAX_RACK lowercase letters
+ * @param words where the words go; only the first max_words are stored
+ * @return the number of words found, or -1 if the rack is bad
+ */
+int tt_subwords(const char *rack, tt_word_t *words, int max_words) {
+  tt_search_t s;
+  int len;
+
+  s.nrack = sorted_letters(rack, TT_MAX_RACK, s.rack);
+  if (s.nrack < 0)
+    return -1;
+  s.words = words;
+  s.max_words = max_words;
+  s.found = 0;
+
+  for (len = TT_MIN_WORD; len <= TT_MAX_WORD && len <= s.nrack; len++)
+    choose(&s, 0, len, len, 0);
+  return s.found;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file texttwist_index.h
+ * @brief An anagram index over the TextTwist dictionary
+ *
+ * tt_index_init() sorts the words of texttwist_dict by length and by their
+ * letters in alphabetical order (their "key"; "stop" and "pots" share the
+ * key "opst"). Anagrams then sit together, so checking a word, or finding
+ * every word that can be made from a rack of letters, is a few binary
+ * searches rather than a scan of the dictionary.
+ */
+
+#ifndef _TEXTTWIST_INDEX_H_
+#define _TEXTTWIST_INDEX_H_
+
+#include "texttwist_dict.h"
+
+/** Most letters in a rack */
+#define TT_MAX_RACK 12
+
+/** Most words the index holds */
+#define TT_INDEX_WORDS 10240
+
+/** A word of the dictionary; its text is not NUL-terminated */
+typedef struct tt_word {
+  const char *text;
+  int len;
+} tt_word_t;
+
+int tt_index_init(void);
+int tt_is_word(const char *word);
+int tt_subwords(const char *rack, tt_word_t *words, int max_words);
+
+#endif /* _TEXTTWIST_INDEX_H_ */
@@ -0,0 +1,129 @@
+/**
+ * @brief Build-time packer for the TextTwist dictionary
+ *
+ * This is a host program, linked against texttwist_dict.c, which prints the
+ * dictionary as the C source of the word graph described in
+ * texttwist_dawg.h. It builds a trie of the words, then merges nodes from
+ * the leaves up: two nodes whose edges have the same letters, end marks and
+ * (already merged) targets are the same node.
+ *
+ * It exits with a nonzero status, and prints nothing useful, if a word isn't
+ * TT_MIN_WORD to TT_MAX_WORD lowercase letters, so a bad dictionary fails
+ * the build.
+ */
+
+#include <stdio.h>
+#include "texttwist_dict.h"
+#include "texttwist_dawg.h"
+
+#define MAX_NODES 131072
+
+/* Slots in the table of merged nodes: a power of two, and more than there
+ * can be nodes, so it never fills */
+#define HASH_SLOTS (2 * MAX_NODES)
+
+static int child[MAX_NODES][26];
+static char end[MAX_NODES];
+static int nnodes = 1;
+
+/* The merged nodes, numbered from 1: node k's edges are
+ * edges[first[k]] through edges[first[k] + nedges[k] - 1], each holding
+ * its letter, TT_DAWG_END, and its target's number << 8 */
+static unsigned int edges[MAX_NODES];
+static int first[MAX_NODES], nedges[MAX_NODES];
+static int nmerged, nedges_total;
+
+static int table[HASH_SLOTS];
+
+/* Where each merged node goes in tt_dawg[] */
+static int place[MAX_NODES];
+
+static int bad(const char *word, int len, const char *why) {
+  printf("#error \"texttwist_dict word '%.*s': %s\"\n", len, word, why);
+  return 1;
+}
+
+/* Returns the number of the merged node the same as trie node n, or 0 if
+ * n has no edges */
+static int merge(int n) {
+  unsigned int e[26], h = 0;
+  int c, k, i, count = 0, slot;
+
+  for (c = 0; c < 26; c++) {
+    if (child[n][c] == 0)
+      continue;
+    e[count] = c | (end[child[n][c]] ? TT_DAWG_END : 0) |
+               merge(child[n][c]) << 8;
+    h = (h ^ e[count++]) * 0x9e3779b1u;
+  }
+  if (count == 0)
+    return 0;
+
+  for (slot = h & (HASH_SLOTS - 1); (k = table[slot]) != 0;
+       slot = (slot + 1) & (HASH_SLOTS - 1)) {
+    if (nedges[k] != count)
+      continue;
+    for (i = 0; i < count && edges[first[k] + i] == e[i]; i++)
+      continue;
+    if (i == count)
+      return k;
+  }
+
+  k = table[slot] = ++nmerged;
+  first[k] = nedges_total;
+  nedges[k] = count;
+  for (i = 0; i < count; i++)
+    edges[nedges_total++] = e[i];
+  return k;
+}
+
+int main(void) {
+  const char *p = texttwist_dict;
+  int len, n, i, k, root, pos;
+
+  while (*p != '\0') {
+    if (*p == ' ') {
+      p++;
+      continue;
+    }
+    for (len = 0; p[len] != ' ' && p[len] != '\0'; len++)
+      continue;
+    if (len < TT_MIN_WORD || len > TT_MAX_WORD)
+      return bad(p, len, "bad length");
+    for (n = 0, i = 0; i < len; i++) {
+      if (p[i] < 'a' || p[i] > 'z')
+        return bad(p, len, "not lowercase letters");
+      if (child[n][p[i] - 'a'] == 0) {
+        if (nnodes == MAX_NODES)
+          return bad(p, len, "too many trie nodes");
+        child[n][p[i] - 'a'] = nnodes++;
+      }
+      n = child[n][p[i] - 'a'];
+    }
+    end[n] = 1;
+    p += len;
+  }
+  root = merge(0);
+
+  /* The root goes first, at TT_DAWG_ROOT; the rest follow in any order */
+  for (pos = TT_DAWG_ROOT, k = root; k > 0; k--) {
+    place[k] = pos;
+    pos += nedges[k];
+  }
+
+  printf("/* Generated from texttwist_dict.c by texttwist_pack; "
+         "do not edit. */\n\n");
+  printf("#include \"texttwist_dawg.h\"\n\n");
+  printf("const unsigned int tt_dawg_edges = %d;\n\n", pos);
+  printf("const unsigned int tt_dawg[%d] = {\n  0x0,", pos);
+  for (n = TT_DAWG_ROOT, k = root; k > 0; k--) {
+    for (i = 0; i < nedges[k]; i++, n++) {
+      unsigned int e = edges[first[k] + i];
+      printf("%s0x%x,", n % 8 == 0 ? "\n  " : " ",
+             (e & 0xff) | (i == nedges[k] - 1 ? TT_DAWG_LAST : 0) |
+             place[e >> 8] << 8);
+    }
+  }
+  printf("\n};\n");
+  return 0;
+}
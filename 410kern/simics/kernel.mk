@@ -1,6 +1,7 @@
 410K_SIMICS_OBJS := \
 				simics.o   \
-				simics_c.o 
+				simics_c.o \
+				simics_log.o
 
 410K_SIMICS_OBJS := $(410K_SIMICS_OBJS:%=$(410KDIR)/simics/%)
 
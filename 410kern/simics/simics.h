@@ -16,6 +16,29 @@
 #define SIM_REG_CHILD       0x04100007
 #define SIM_BOOTED          0x04100008
 
+/* Log levels for SIM_LOG_LEVEL and lprintf_level() */
+#define SIM_LOG_OFF         0
+#define SIM_LOG_ERROR       1
+#define SIM_LOG_WARN        2
+#define SIM_LOG_INFO        3
+#define SIM_LOG_DEBUG       4
+
+/* Messages above this level are compiled out; plain lprintf() is INFO.
+ * Build with e.g. -DSIM_LOG_LEVEL=SIM_LOG_WARN to silence chatter. */
+#ifndef SIM_LOG_LEVEL
+#define SIM_LOG_LEVEL       SIM_LOG_DEBUG
+#endif
+
+/* sim_log() flushes after this many messages ... */
+#ifndef SIM_LOG_BATCH
+#define SIM_LOG_BATCH       32
+#endif
+
+/* ... or when sim_log_tick() sees this many ticks since the last flush */
+#ifndef SIM_LOG_FLUSH_TICKS
+#define SIM_LOG_FLUSH_TICKS 1
+#endif
+
 #ifdef ASSEMBLER
 
 #define lprintf sim_printf
@@ -55,6 +78,19 @@ extern void sim_unreg_process(void *cr3);
 /** @brief Convenience wrapper around sprintf for simics */
 extern void sim_printf(const char *fmt, ...) __attribute__((__format__ (__printf__, 1, 2)));
 
+/** @brief Appends a message to the batched debug log
+ *
+ *  The message is formatted into a kernel buffer and reaches the simics
+ *  console, together with the rest of its batch, in a single sim_puts().
+ */
+extern void sim_log(const char *fmt, ...) __attribute__((__format__ (__printf__, 1, 2)));
+
+/** @brief Writes out any batched log messages now */
+extern void sim_log_flush(void);
+
+/** @brief Flushes the batched log if a tick has passed; call from tick() */
+extern void sim_log_tick(unsigned int numTicks);
+
 /** @brief Notify simics that we have booted.
  *
  *  This is done for you in 410kern/entry.c
@@ -63,7 +99,19 @@ extern void sim_booted(const char *kern);
 
 /* "Compatibility mode" for old code */
 #define MAGIC_BREAK sim_breakpoint()
+#if SIM_LOG_LEVEL >= SIM_LOG_INFO
 #define lprintf(...) sim_printf(__VA_ARGS__)
+#else
+#define lprintf(...) ((void)0)
+#endif
+
+/* Batched logging at a given level.  The condition is a compile-time
+ * constant, so disabled calls and their arguments vanish entirely. */
+#define lprintf_level(level, ...)                 \
+  do {                                            \
+    if ((level) <= SIM_LOG_LEVEL)                 \
+      sim_log(__VA_ARGS__);                       \
+  } while (0)
 
 #endif /* !ASSEMBLER */
 
@@ -0,0 +1,92 @@
+/** @file simics_log.c
+ *  @brief Batched debug log channel.
+ *
+ *  sim_printf() costs a formatter pass into a stack buffer and a simulator
+ *  trap per message.  sim_log() instead formats directly into a static
+ *  kernel buffer and leaves the message there; the accumulated batch is
+ *  handed to sim_puts() as one newline-separated string once
+ *  SIM_LOG_BATCH messages are pending, when the buffer is nearly full, or
+ *  when sim_log_tick() sees that SIM_LOG_FLUSH_TICKS timer ticks have
+ *  passed since the last flush.
+ *
+ *  The buffer is shared with interrupt handlers, so it is only touched with
+ *  interrupts disabled.
+ */
+
+#include <simics.h>
+#include <stdarg.h>
+#include <stdio/stdio.h>
+#include <x86/asm.h>
+#include <x86/eflags.h>
+
+/* Bytes of message text buffered between flushes */
+#define SIM_LOG_BUF_SIZE 4096
+
+/* Longest single message; longer ones are truncated like sim_printf()'s */
+#define SIM_LOG_MSG_MAX 256
+
+static char log_buf[SIM_LOG_BUF_SIZE];
+static int log_len;             /* bytes of log_buf in use */
+static int log_pending;         /* messages in log_buf */
+static unsigned int log_last_flush;   /* tick of the last sim_log_tick() flush */
+
+/* Emits the batch; called with interrupts disabled */
+static void log_flush_locked(void)
+{
+  if (log_pending == 0)
+    return;
+
+  /* Each message ends in '\n'; the last one becomes the terminator */
+  log_buf[log_len - 1] = '\0';
+  sim_puts(log_buf);
+  log_len = 0;
+  log_pending = 0;
+}
+
+void sim_log(const char *fmt, ...)
+{
+  va_list ap;
+  uint32_t eflags = get_eflags();
+  int len;
+
+  disable_interrupts();
+
+  if (log_len + SIM_LOG_MSG_MAX > SIM_LOG_BUF_SIZE)
+    log_flush_locked();
+
+  /* vsnprintf() stores up to size characters plus the NUL */
+  va_start(ap, fmt);
+  len = vsnprintf(&log_buf[log_len], SIM_LOG_MSG_MAX - 1, fmt, ap);
+  va_end(ap);
+
+  log_len += len;
+  log_buf[log_len++] = '\n';
+
+  if (++log_pending >= SIM_LOG_BATCH)
+    log_flush_locked();
+
+  set_eflags(eflags);
+}
+
+void sim_log_flush(void)
+{
+  uint32_t eflags = get_eflags();
+
+  disable_interrupts();
+  log_flush_locked();
+  set_eflags(eflags);
+}
+
+void sim_log_tick(unsigned int numTicks)
+{
+  uint32_t eflags;
+
+  if (log_pending == 0 || numTicks - log_last_flush < SIM_LOG_FLUSH_TICKS)
+    return;
+
+  eflags = get_eflags();
+  disable_interrupts();
+  log_last_flush = numTicks;
+  log_flush_locked();
+  set_eflags(eflags);
+}
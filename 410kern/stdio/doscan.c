@@ -145,7 +145,7 @@ _doscan(const unsigned char *fmt, va_list vp,
 			buf = va_arg(vp, char *);
 
 		c = getc(getc_arg);
-		while (!isspace(c))
+		while (c != '\0' && !isspace(c))	/* stop at the end, too */
 		{
 		    if (!discard)
 		    	*buf++ = c;
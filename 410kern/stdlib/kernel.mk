@@ -4,6 +4,7 @@
 						ctype.o   \
 						panic.o   \
                         qsort.o   \
+                        qsort_typed.o \
                         rand.o    \
 						strtol.o  \
 						strtoul.o \
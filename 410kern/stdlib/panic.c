@@ -35,6 +35,7 @@ void panic(const char *fmt, ...)
 	va_start(vl, fmt);
 	vsnprintf(buf, sizeof (buf), fmt, vl);
 	va_end(vl);
+	sim_log_flush();
 	lprintf(buf);
 
 	va_start(vl, fmt);
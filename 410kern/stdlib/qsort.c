@@ -36,9 +36,17 @@
 
 static inline char	*med3(char *, char *, char *, int (*)());
 static inline void	 swapfunc(char *, char *, int, int);
+static void		 introsort(char *, size_t, size_t, int (*)(), int);
 
 #define min(a, b)	(a) < (b) ? a : b
 
+/*
+ * Subarrays shorter than this are finished with a straight insertion sort.
+ * Every step of it costs an indirect comparison call, so the cutoff stays
+ * close to Bentley & McIlroy's original value.
+ */
+#define QSORT_INSERTION_CUTOFF	7
+
 /*
  * Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
  */
@@ -87,24 +95,68 @@ med3(a, b, c, cmp)
               :(cmp(b, c) > 0 ? b : (cmp(a, c) < 0 ? a : c ));
 }
 
-void
-qsort(a, n, es, cmp)
-	void *a;
-	size_t n, es;
-	int (*cmp)();
+/*
+ * Restore the heap property below element "root" of the n-element heap a.
+ */
+static void
+siftdown(char *a, size_t root, size_t n, size_t es, int (*cmp)(), int swaptype)
+{
+	size_t child;
+
+	while ((child = 2 * root + 1) < n) {
+		if (child + 1 < n && cmp(a + child * es, a + (child + 1) * es) < 0)
+			child++;
+		if (cmp(a + root * es, a + child * es) >= 0)
+			return;
+		swap(a + root * es, a + child * es);
+		root = child;
+	}
+}
+
+/*
+ * Fallback used once quicksort has partitioned too many times without
+ * shrinking the problem, which only happens on adversarial input.
+ */
+static void
+heapsort_es(char *a, size_t n, size_t es, int (*cmp)(), int swaptype)
+{
+	size_t i;
+
+	for (i = n / 2; i > 0; i--)
+		siftdown(a, i - 1, n, es, cmp, swaptype);
+	for (i = n - 1; i > 0; i--) {
+		swap(a, a + i * es);
+		siftdown(a, 0, i, es, cmp, swaptype);
+	}
+}
+
+/*
+ * Introsort: Bentley & McIlroy's quicksort, but once "depth" partitioning
+ * rounds have been spent on a subarray it is handed to heapsort, so the
+ * worst case is O(n log n) rather than O(n^2).
+ *
+ * The original code also switched to insertion sort whenever a partition
+ * pass made no swaps; that is quadratic on inputs built to defeat it, so it
+ * is gone.
+ */
+static void
+introsort(char *a, size_t n, size_t es, int (*cmp)(), int depth)
 {
 	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-	int d, r, swaptype, swap_cnt;
+	int d, r, swaptype;
 
 loop:	SWAPINIT(a, es);
-	swap_cnt = 0;
-	if (n < 7) {
-		for (pm = a + es; pm < (char *) a + n * es; pm += es)
-			for (pl = pm; pl > (char *) a && cmp(pl - es, pl) > 0;
+	if (n < QSORT_INSERTION_CUTOFF) {
+		for (pm = a + es; pm < a + n * es; pm += es)
+			for (pl = pm; pl > a && cmp(pl - es, pl) > 0;
 			     pl -= es)
 				swap(pl, pl - es);
 		return;
 	}
+	if (depth-- == 0) {
+		heapsort_es(a, n, es, cmp, swaptype);
+		return;
+	}
 	pm = a + (n / 2) * es;
 	if (n > 7) {
 		pl = a;
@@ -124,7 +176,6 @@ loop:	SWAPINIT(a, es);
 	for (;;) {
 		while (pb <= pc && (r = cmp(pb, a)) <= 0) {
 			if (r == 0) {
-				swap_cnt = 1;
 				swap(pa, pb);
 				pa += es;
 			}
@@ -132,7 +183,6 @@ loop:	SWAPINIT(a, es);
 		}
 		while (pb <= pc && (r = cmp(pc, a)) >= 0) {
 			if (r == 0) {
-				swap_cnt = 1;
 				swap(pc, pd);
 				pd -= es;
 			}
@@ -141,30 +191,37 @@ loop:	SWAPINIT(a, es);
 		if (pb > pc)
 			break;
 		swap(pb, pc);
-		swap_cnt = 1;
 		pb += es;
 		pc -= es;
 	}
-	if (swap_cnt == 0) {  /* Switch to insertion sort */
-		for (pm = a + es; pm < (char *) a + n * es; pm += es)
-			for (pl = pm; pl > (char *) a && cmp(pl - es, pl) > 0;
-			     pl -= es)
-				swap(pl, pl - es);
-		return;
-	}
 
 	pn = a + n * es;
-	r = min(pa - (char *)a, pb - pa);
+	r = min(pa - a, pb - pa);
 	vecswap(a, pb - r, r);
 	r = min(pd - pc, pn - pd - es);
 	vecswap(pb, pn - r, r);
 	if ((r = pb - pa) > es)
-		qsort(a, r / es, es, cmp);
+		introsort(a, r / es, es, cmp, depth);
 	if ((r = pd - pc) > es) {
 		/* Iterate rather than recurse to save stack space */
 		a = pn - r;
 		n = r / es;
 		goto loop;
 	}
-/*		qsort(pn - r, r / es, es, cmp);*/
+}
+
+void
+qsort(a, n, es, cmp)
+	void *a;
+	size_t n, es;
+	int (*cmp)();
+{
+	int depth = 0;
+	size_t m;
+
+	/* Allow 2 * floor(lg n) partitioning rounds before giving up */
+	for (m = n; m > 1; m >>= 1)
+		depth += 2;
+
+	introsort(a, n, es, cmp, depth);
 }
@@ -0,0 +1,13 @@
+/** @file qsort_typed.c
+ *  @brief Type-specialized sorts for the common scalar cases.
+ *
+ *  Callers with their own record types should instantiate SORTGEN_DEFINE()
+ *  from sortgen.h next to the type instead of adding to this file.
+ */
+
+#include <types.h>
+#include <stdlib/stdlib.h>
+#include <stdlib/sortgen.h>
+
+SORTGEN_DEFINE(, qsort_int, int, SORTGEN_LESS)
+SORTGEN_DEFINE(, qsort_uint, unsigned int, SORTGEN_LESS)
@@ -0,0 +1,148 @@
+/** @file sortgen.h
+ *  @brief Generator for type-specialized introsorts.
+ *
+ *  qsort() has to call its comparator through a pointer and move elements
+ *  a byte or a word at a time, because it knows nothing about them.  When
+ *  the element type is known at compile time,
+ *
+ *    SORTGEN_DEFINE(static, score_sort, score_t, score_less)
+ *
+ *  expands to a function
+ *
+ *    static void score_sort(score_t *a, size_t n);
+ *
+ *  which sorts a[0..n) in ascending order with the comparison inlined and
+ *  whole elements copied by assignment.  "less" may be a macro or a
+ *  function taking two (const type *) arguments and returning nonzero iff
+ *  the first sorts strictly before the second.  Like qsort() the result is
+ *  not stable.
+ *
+ *  The algorithm is introsort: median-of-three quicksort that falls back to
+ *  heapsort after 2 * lg(n) partitioning rounds, with subarrays below
+ *  SORTGEN_INSERTION_CUTOFF finished by insertion sort.
+ */
+
+#ifndef _SORTGEN_H_
+#define _SORTGEN_H_
+
+#include <types.h>
+
+/*
+ * Inlined comparisons and element moves are cheap, so insertion sort stays
+ * ahead of partitioning for longer than it does in qsort().
+ */
+#define SORTGEN_INSERTION_CUTOFF 16
+
+/** @brief Less-than for scalar types, usable as the "less" argument */
+#define SORTGEN_LESS(x, y) (*(x) < *(y))
+
+#define SORTGEN_DEFINE(scope, name, type, less)				\
+									\
+static inline void							\
+name##_swap(type *x, type *y)						\
+{									\
+	type t = *x;							\
+	*x = *y;							\
+	*y = t;								\
+}									\
+									\
+static void								\
+name##_insertion(type *a, size_t n)					\
+{									\
+	size_t i, j;							\
+									\
+	for (i = 1; i < n; i++) {					\
+		type t = a[i];						\
+		for (j = i; j > 0 && less(&t, &a[j - 1]); j--)		\
+			a[j] = a[j - 1];				\
+		a[j] = t;						\
+	}								\
+}									\
+									\
+static void								\
+name##_siftdown(type *a, size_t root, size_t n)				\
+{									\
+	size_t child;							\
+									\
+	while ((child = 2 * root + 1) < n) {				\
+		if (child + 1 < n && less(&a[child], &a[child + 1]))	\
+			child++;					\
+		if (!less(&a[root], &a[child]))				\
+			return;						\
+		name##_swap(&a[root], &a[child]);			\
+		root = child;						\
+	}								\
+}									\
+									\
+static void								\
+name##_heapsort(type *a, size_t n)					\
+{									\
+	size_t i;							\
+									\
+	for (i = n / 2; i > 0; i--)					\
+		name##_siftdown(a, i - 1, n);				\
+	for (i = n - 1; i > 0; i--) {					\
+		name##_swap(&a[0], &a[i]);				\
+		name##_siftdown(a, 0, i);				\
+	}								\
+}									\
+									\
+static void								\
+name##_introsort(type *a, size_t n, int depth)				\
+{									\
+	while (n >= SORTGEN_INSERTION_CUTOFF) {				\
+		type *mid = &a[n / 2];					\
+		type pivot;						\
+		size_t i, j;						\
+									\
+		if (depth-- == 0) {					\
+			name##_heapsort(a, n);				\
+			return;						\
+		}							\
+									\
+		/* Order a[0] <= *mid <= a[n - 1]; the ends then act	\
+		 * as sentinels for the partitioning scans. */		\
+		if (less(mid, &a[0]))					\
+			name##_swap(mid, &a[0]);			\
+		if (less(&a[n - 1], mid)) {				\
+			name##_swap(mid, &a[n - 1]);			\
+			if (less(mid, &a[0]))				\
+				name##_swap(mid, &a[0]);		\
+		}							\
+		pivot = *mid;						\
+									\
+		i = 0;							\
+		j = n - 1;						\
+		for (;;) {						\
+			do i++; while (less(&a[i], &pivot));		\
+			do j--; while (less(&pivot, &a[j]));		\
+			if (i >= j)					\
+				break;					\
+			name##_swap(&a[i], &a[j]);			\
+		}							\
+									\
+		/* Recurse on the smaller side, loop on the larger */	\
+		if (j + 1 < n - j - 1) {				\
+			name##_introsort(a, j + 1, depth);		\
+			a += j + 1;					\
+			n -= j + 1;					\
+		} else {						\
+			name##_introsort(a + j + 1, n - j - 1, depth);	\
+			n = j + 1;					\
+		}							\
+	}								\
+	name##_insertion(a, n);						\
+}									\
+									\
+scope void								\
+name(type *a, size_t n)							\
+{									\
+	int depth = 0;							\
+	size_t m;							\
+									\
+	for (m = n; m > 1; m >>= 1)					\
+		depth += 2;						\
+	name##_introsort(a, n, depth);					\
+}
+
+#endif /* _SORTGEN_H_ */
@@ -16,6 +16,8 @@ void srand(unsigned new_seed);
 int abs(int val);
 
 void qsort(void *a, size_t n, size_t es, int (*cmp)());
+void qsort_int(int *a, size_t n);
+void qsort_uint(unsigned int *a, size_t n);
 
 void panic(const char *, ...);
 
@@ -1,5 +1,7 @@
 410KLIB_STRING_OBJS:= \
+                        memchr.o     \
                         memcmp.o     \
+                        memmem.o     \
                         memset.o     \
                         rindex.o     \
                         strcat.o     \
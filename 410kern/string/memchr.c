@@ -0,0 +1,25 @@
+/** @file memchr.c
+ *  @brief Locate a byte in a block of memory.
+ */
+
+#include <types.h>
+#include <string.h>
+
+/*
+ * Return a pointer to the first occurrence of (unsigned char)c in the first
+ * n bytes of s, or 0 if there is none.  Unlike strchr() this does not stop
+ * at a NUL, which makes it the inner loop of memmem() and strstr().
+ */
+void *
+memchr(const void *s, int c, size_t n)
+{
+	register const unsigned char *p = s;
+	register unsigned char uc = c;
+
+	while (n-- > 0) {
+		if (*p == uc)
+			return (void *)p;
+		p++;
+	}
+	return 0;
+}
@@ -0,0 +1,84 @@
+/** @file memmem.c
+ *  @brief Locate a byte string inside another, with explicit lengths.
+ *
+ *  Short needles and short haystacks are handled by skipping to each
+ *  occurrence of the needle's first byte with memchr() and comparing the
+ *  rest in place.  Everything else uses Boyer-Moore-Horspool: after a
+ *  mismatch the window slides by the distance from the last occurrence
+ *  (within the needle) of the haystack byte under the needle's final
+ *  position, so most windows are rejected after looking at one byte.
+ *
+ *  The shift table is a byte per entry so that it costs 256 bytes of a
+ *  4 KB kernel stack; shifts for needles longer than that are clamped,
+ *  which only makes the search step more cautiously.
+ */
+
+#include <types.h>
+#include <string.h>
+
+/* Below these sizes building the 256-entry shift table does not pay off */
+#define BMH_MIN_NEEDLE   3
+#define BMH_MIN_HAYSTACK 256
+
+static void *
+memmem_firstbyte(const unsigned char *h, size_t hlen,
+                 const unsigned char *n, size_t nlen)
+{
+	const unsigned char *end = h + hlen - nlen + 1; /* last window start + 1 */
+
+	while (h < end) {
+		h = memchr(h, n[0], end - h);
+		if (h == 0)
+			return 0;
+		if (!memcmp(h + 1, n + 1, nlen - 1))
+			return (void *)h;
+		h++;
+	}
+	return 0;
+}
+
+static void *
+memmem_bmh(const unsigned char *h, size_t hlen,
+           const unsigned char *n, size_t nlen)
+{
+	unsigned char shift[256];
+	size_t last = nlen - 1;
+	size_t i;
+	unsigned char tail = n[last];
+
+	memset(shift, nlen > 255 ? 255 : nlen, sizeof(shift));
+	for (i = 0; i < last; i++)
+		shift[n[i]] = last - i > 255 ? 255 : last - i;
+
+	while (hlen >= nlen) {
+		unsigned char c = h[last];
+
+		if (c == tail && !memcmp(h, n, last))
+			return (void *)h;
+		h += shift[c];
+		hlen -= shift[c];
+	}
+	return 0;
+}
+
+/*
+ * Return a pointer to the first occurrence of the nlen-byte string needle
+ * within the hlen bytes at haystack, or 0 if there is none.  An empty
+ * needle matches at the start of the haystack.
+ */
+void *
+memmem(const void *haystack, size_t hlen, const void *needle, size_t nlen)
+{
+	const unsigned char *h = haystack;
+	const unsigned char *n = needle;
+
+	if (nlen == 0)
+		return (void *)h;
+	if (hlen < nlen)
+		return 0;
+	if (nlen == 1)
+		return memchr(h, n[0], hlen);
+	if (nlen < BMH_MIN_NEEDLE || hlen < BMH_MIN_HAYSTACK)
+		return memmem_firstbyte(h, hlen, n, nlen);
+	return memmem_bmh(h, hlen, n, nlen);
+}
@@ -41,6 +41,9 @@ size_t strcspn(const char *__s1, const char *__s2);
 
 void *memset(void *__to, int __ch, unsigned int __n);
 int memcmp(const void *s1v, const void *s2v, int size);
+void *memchr(const void *__s, int __c, size_t __n);
+void *memmem(const void *__haystack, size_t __hlen,
+             const void *__needle, size_t __nlen);
 
 /* FIXME These are defined here only by tradition... we should move them. */
 void *memcpy(void *__to, const void *__from, unsigned int __n);
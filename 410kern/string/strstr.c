@@ -17,21 +17,25 @@
  */
 
 #include <string.h>
-#include <stdlib.h>
 
+/*
+ * The needle is usually a short word and the haystack a long text, so both
+ * lengths are measured once and the search itself is left to memmem(), which
+ * skips ahead instead of comparing at every haystack position.
+ */
 char *strstr(const char *haystack, const char *needle)
 {
-	int hlen = strlen(haystack);
-	int nlen = strlen(needle);
+	size_t nlen = strlen(needle);
+	size_t hlen;
 
-	while (hlen >= nlen)
-	{
-		if (!memcmp(haystack, needle, nlen))
-			return (void*)haystack;
+	if (nlen == 0)
+		return (char *)haystack;
 
-		haystack++;
-		hlen--;
-	}
-	return 0;
-}
+	/* A haystack without the needle's first byte can't match at all */
+	haystack = strchr(haystack, needle[0]);
+	if (haystack == 0)
+		return 0;
 
+	hlen = strlen(haystack);
+	return memmem(haystack, hlen, needle, nlen);
+}
@@ -559,6 +559,10 @@ process_extended_scan(int keypress, int pressed)
       /* UP */
       rcode = code=KHE_ARROW_UP;
       break;
+    case 0x49:
+      /* PAGE UP */
+      rcode = code = KHE_PAGE_UP;
+      break;
     case 0x4b:
       /* LEFT */
       rcode = code=KHE_ARROW_LEFT;
@@ -571,6 +575,10 @@ process_extended_scan(int keypress, int pressed)
       /* DOWN */
       rcode = code = KHE_ARROW_DOWN;
       break;
+    case 0x51:
+      /* PAGE DOWN */
+      rcode = code = KHE_PAGE_DOWN;
+      break;
     case 0x53:
       /* DEL */
       rcode = code = 0x7F;
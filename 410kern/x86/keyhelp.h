@@ -194,14 +194,15 @@ enum kh_extended_e {
    */
    /* KHE_BEGIN, */
 
+  KHE_PAGE_UP,
+  KHE_PAGE_DOWN,
+
   /**
    * @bug We do not handle these at the moment.
    */
   /* KHE_HOME, */
   /* KHE_END, */
   /* KHE_INSERT, */
-  /* KHE_PAGE_UP, */
-  /* KHE_PAGE_DOWN, */
   /* KHE_APPS, */ /* The "context menu" key */
 };
 
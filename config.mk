@@ -30,7 +30,7 @@ TABSTOP = 8
 # the object files which make up your drivers.
 ##################################################
 #
-COMMON_OBJS = fake.o console_device_driver.o install_handlers.o interrupt_handler_wrappers.o
+COMMON_OBJS = fake.o console_device_driver.o console_cells.o scrollback.o sprite.o window.o ansi.o serial.o framerec.o recorder.o install_handlers.o interrupt_handler_wrappers.o
 
 ##################################################
 # Object files from 410kern/ for just the game
@@ -0,0 +1,168 @@
+/** @file ansi.c
+ *
+ *  @brief ANSI escape sequence parsing for the console
+ *  This is the part of the console's escape handling that doesn't touch
+ *  the screen: finding where plain text stops, parsing CSI sequences a
+ *  byte at a time (so a sequence may be split across putbytes() calls),
+ *  and working out the color an SGR sequence selects. The driver acts on
+ *  the sequences.
+ *
+ *  @bug No known bugs
+ */
+
+#include <stdint.h>
+#include <video_defines.h>
+#include <ansi.h>
+
+/* Does some byte of the word come before ' '? */
+#define HAS_CONTROL(x) (((x) - 0x20202020u) & ~(x) & 0x80808080u)
+
+/* Bytes that end a run of plain text */
+static const unsigned char stops[256] = {
+	['\b'] = 1, ['\n'] = 1, ['\r'] = 1, [ANSI_ESC] = 1,
+};
+
+/* ANSI numbers colors black, red, green, yellow, blue, magenta, cyan,
+ * white; VGA swaps red with blue and yellow with cyan */
+static const unsigned char vga_color[8] = {
+	FGND_BLACK, FGND_RED, FGND_GREEN, FGND_BRWN,
+	FGND_BLUE, FGND_MAG, FGND_CYAN, FGND_LGRAY,
+};
+
+/** @brief How many bytes at the start of s are printed as they are
+ *
+ *  Text is checked four bytes at a time; only words holding a control
+ *  character are looked at byte by byte.
+ */
+int ansi_plain_run(const char *s, int len)
+{
+	int i = 0;
+
+	for(;;)
+	{
+		while(i + 4 <= len && !HAS_CONTROL(*(const uint32_t *)(s + i)))
+			i += 4;
+		if(i >= len || stops[(unsigned char)s[i]])
+			return i;
+		i++;
+	}
+}
+
+/** @brief Starts a sequence: the ESC has been seen */
+void ansi_start(ansi_parser_t *p)
+{
+	p->state = ANSI_ESCAPE;
+}
+
+/** @brief Takes the next byte of a sequence
+ *
+ *  @return ANSI_DONE if ch ended a CSI sequence, else ANSI_MORE. Either
+ *          way, the parser is back in ANSI_GROUND once the sequence is
+ *          over or found not to be CSI.
+ */
+int ansi_parse(ansi_parser_t *p, char ch)
+{
+	if(p->state == ANSI_ESCAPE)
+	{
+		if(ch != '[')
+		{
+			p->state = ANSI_GROUND;
+			return ANSI_MORE;
+		}
+		p->state = ANSI_CSI;
+		p->nparams = 0;
+		p->params[0] = 0;
+		p->private = 0;
+		return ANSI_MORE;
+	}
+
+	if(ch >= '0' && ch <= '9')
+	{
+		int *param;
+
+		if(p->nparams == 0)
+			p->nparams = 1;
+		if(p->nparams > ANSI_MAX_PARAMS)
+			return ANSI_MORE;
+		param = &p->params[p->nparams - 1];
+		*param = *param * 10 + (ch - '0');
+		if(*param > ANSI_MAX_PARAM)
+			*param = ANSI_MAX_PARAM;
+	}
+	else if(ch == ';')
+	{
+		/* A ';' with nothing before it ends an empty first parameter */
+		if(p->nparams == 0)
+			p->nparams = 1;
+		if(++p->nparams <= ANSI_MAX_PARAMS)
+			p->params[p->nparams - 1] = 0;
+	}
+	else if(ch >= 0x3C && ch <= 0x3F)
+	{
+		p->private = ch;
+	}
+	else if(ch >= 0x40 && ch <= 0x7E)
+	{
+		p->final = ch;
+		if(p->nparams > ANSI_MAX_PARAMS)
+			p->nparams = ANSI_MAX_PARAMS;
+		p->state = ANSI_GROUND;
+		return ANSI_DONE;
+	}
+	/* Intermediate bytes and anything else are skipped */
+	return ANSI_MORE;
+}
+
+/** @brief Parameter i of the sequence, or dflt if it is missing or 0 */
+int ansi_param(const ansi_parser_t *p, int i, int dflt)
+{
+	if(i >= p->nparams || p->params[i] == 0)
+		return dflt;
+	return p->params[i];
+}
+
+/** @brief The color an SGR (ESC [ ... m) sequence leaves
+ *
+ *  Handles reset (0), bold (1, 22) as the bright foreground, blink (5, 25),
+ *  reverse (7), and the foreground (30-37, 39, 90-97) and background
+ *  (40-47, 49) colors.
+ *
+ *  @param color the color before the sequence
+ *  @param dflt the color reset goes back to
+ */
+int ansi_sgr(const ansi_parser_t *p, int color, int dflt)
+{
+	int i, n;
+
+	if(p->nparams == 0)
+		return dflt;
+
+	for(i = 0; i < p->nparams; i++)
+	{
+		n = p->params[i];
+		if(n == 0)
+			color = dflt;
+		else if(n == 1)
+			color |= FGND_DGRAY;
+		else if(n == 22)
+			color &= ~FGND_DGRAY;
+		else if(n == 5)
+			color |= BLINK;
+		else if(n == 25)
+			color &= ~BLINK;
+		else if(n == 7)
+			color = (color & BLINK) | ((color & 0x0F) << 4 & 0x70)
+			        | ((color >> 4) & 0x07);
+		else if(n >= 30 && n <= 37)
+			color = (color & ~0x07) | vga_color[n - 30];
+		else if(n == 39)
+			color = (color & ~0x0F) | (dflt & 0x0F);
+		else if(n >= 90 && n <= 97)
+			color = (color & ~0x0F) | vga_color[n - 90] | FGND_DGRAY;
+		else if(n >= 40 && n <= 47)
+			color = (color & ~0x70) | vga_color[n - 40] << 4;
+		else if(n == 49)
+			color = (color & ~0x70) | (dflt & 0x70);
+	}
+	return color & 0xFF;
+}
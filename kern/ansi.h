@@ -0,0 +1,46 @@
+/** @file ansi.h
+ *  @brief Recognizing ANSI escape sequences in console output
+ *
+ *  Only CSI sequences (ESC [ params final) are understood; ESC followed by
+ *  anything else is dropped along with that byte.
+ */
+
+#ifndef __ANSI_H
+#define __ANSI_H
+
+#define ANSI_ESC '\033'
+
+/* Parameters past this many are parsed and dropped */
+#define ANSI_MAX_PARAMS 4
+
+/* Largest parameter value kept; bigger ones are clamped */
+#define ANSI_MAX_PARAM 9999
+
+/* States of ansi_parser_t */
+#define ANSI_GROUND 0   /* not in a sequence */
+#define ANSI_ESCAPE 1   /* after ESC */
+#define ANSI_CSI    2   /* after ESC [ */
+
+/* Results of ansi_parse() */
+#define ANSI_MORE 0     /* the sequence goes on */
+#define ANSI_DONE 1     /* final, params and nparams hold a whole sequence */
+
+typedef struct {
+	int state;
+	int nparams;
+	int params[ANSI_MAX_PARAMS];
+	char private;       /* '?' etc. before the parameters, or 0 */
+	char final;         /* the byte ending the sequence */
+} ansi_parser_t;
+
+int ansi_plain_run(const char *s, int len);
+
+void ansi_start(ansi_parser_t *p);
+
+int ansi_parse(ansi_parser_t *p, char ch);
+
+int ansi_param(const ansi_parser_t *p, int i, int dflt);
+
+int ansi_sgr(const ansi_parser_t *p, int color, int dflt);
+
+#endif
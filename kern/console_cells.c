@@ -0,0 +1,52 @@
+/** @file console_cells.c
+ *
+ *  @brief Bulk writes of packed text-mode cells
+ *
+ *  Strides are in cells. Nothing here touches the CRTC or knows where text
+ *  memory is, so the same code draws to the screen and to RAM buffers.
+ *
+ *  @bug No known bugs
+ */
+
+#include <string.h>
+#include <console_cells.h>
+
+/** @brief Writes len characters of s, all in one color, to dst */
+void cells_span(cell_t *dst, const char *s, int len, int color)
+{
+	cell_t attr = MAKE_CELL(0,color);
+	int i;
+
+	for(i = 0; i < len; i++)
+		dst[i] = attr | (unsigned char)s[i];
+}
+
+/** @brief Fills an h x w rectangle with one cell */
+void cells_fill(cell_t *dst, int dst_stride, int h, int w, cell_t cell)
+{
+	int i;
+
+	for(; h > 0; h--, dst += dst_stride)
+		for(i = 0; i < w; i++)
+			dst[i] = cell;
+}
+
+/** @brief Copies an h x w rectangle of cells */
+void cells_copy(cell_t *dst, int dst_stride, const cell_t *src, int src_stride,
+                int h, int w)
+{
+	for(; h > 0; h--, dst += dst_stride, src += src_stride)
+		memcpy(dst, src, w * sizeof(cell_t));
+}
+
+/** @brief Copies an h x w rectangle of cells, except those equal to key */
+void cells_copy_keyed(cell_t *dst, int dst_stride, const cell_t *src,
+                      int src_stride, int h, int w, cell_t key)
+{
+	int i;
+
+	for(; h > 0; h--, dst += dst_stride, src += src_stride)
+		for(i = 0; i < w; i++)
+			if(src[i] != key)
+				dst[i] = src[i];
+}
@@ -0,0 +1,31 @@
+/** @file console_cells.h
+ *  @brief Bulk writes of packed text-mode cells
+ *
+ *  A cell of text memory is 16 bits: the character in the low byte and its
+ *  color in the high byte. These routines write whole runs and rectangles
+ *  of cells with one 16-bit store each, to text memory or to any buffer
+ *  laid out the same way. They don't clip; their callers do, once per call.
+ */
+
+#ifndef __CONSOLE_CELLS_H
+#define __CONSOLE_CELLS_H
+
+#include <stdint.h>
+
+typedef uint16_t cell_t;
+
+#define MAKE_CELL(ch,color) ((cell_t)((((color) & 0xFF) << 8) | ((ch) & 0xFF)))
+#define CELL_CHAR(cell) ((char)((cell) & 0xFF))
+#define CELL_COLOR(cell) (((cell) >> 8) & 0xFF)
+
+void cells_span(cell_t *dst, const char *s, int len, int color);
+
+void cells_fill(cell_t *dst, int dst_stride, int h, int w, cell_t cell);
+
+void cells_copy(cell_t *dst, int dst_stride, const cell_t *src, int src_stride,
+                int h, int w);
+
+void cells_copy_keyed(cell_t *dst, int dst_stride, const cell_t *src,
+                      int src_stride, int h, int w, cell_t key);
+
+#endif
@@ -13,7 +13,10 @@
 #include <simics.h>    /* Sim breakpoints */
 #include <string.h>
 #include <console_device_driver.h>
-#include <stdlib.h>
+#include <console_cells.h>
+#include <scrollback.h>
+#include <ansi.h>
+#include <serial.h>
 
 #define SUCCESS 1
 #define FAILURE 0
@@ -32,24 +35,113 @@
 
 #define IO_PORT_WIDTH (1 << 8)
 
-#define SCROLL_CONSOLE_BUFFER_LENGTH 2 * (CONSOLE_WIDTH * (CONSOLE_HEIGHT - 1))
-
-#define GET_NEXT_ROW(addr) (addr + (2 * CONSOLE_WIDTH))
-
-#define GET_LAST_ROW(addr) (addr + SCROLL_CONSOLE_BUFFER_LENGTH)
-
-#define CONSOLE_END (CONSOLE_MEM_BASE + (2 * (CONSOLE_WIDTH * CONSOLE_HEIGHT)))
-
-
-int term_color = FGND_WHITE;
-int cursor_hidden = 0;
-char *scroll_console_buffer;
+/* What consoles start out writing in, and what ESC [ 0 m goes back to */
+#define DEFAULT_COLOR FGND_WHITE
+
+#define CLAMP(v,lo,hi) ((v) < (lo) ? (lo) : (v) > (hi) ? (hi) : (v))
+
+#define BLANK_CELL MAKE_CELL(0,cur->term_color)
+
+/* CRTC registers holding the cell at which the display starts */
+#define CRTC_START_MSB_IDX 0x0C
+#define CRTC_START_LSB_IDX 0x0D
+
+/* Pages of text memory start this many cells apart: a screen rounded up,
+ * so eight pages fit in the 32 KB at CONSOLE_MEM_BASE. Each console has
+ * two, to flip between. */
+#define PAGE_CELLS 2048
+
+#define PAGE_ADDR(page) ((cell_t *)CONSOLE_MEM_BASE + PAGE_CELLS * (page))
+
+#define CONSOLE_PAGE(n) (2 * (n))
+
+#define CELL_PTR(row,col) (cur->draw_base + (row)*CONSOLE_WIDTH + (col))
+
+#define SHADOW_PTR(row,col) (&cur->shadow[(row)*CONSOLE_WIDTH + (col)])
+
+#define ON_SCREEN (cur == fg)
+
+/* A bit per row, for masks of rows */
+#if CONSOLE_HEIGHT > 32
+#error "row masks need a bit per row"
+#endif
+
+#define ROW_MASK(row,h) ((((h) < 32 ? 1u << (h) : 0u) - 1) << (row))
+
+#define ALL_ROWS ROW_MASK(0,CONSOLE_HEIGHT)
+
+typedef struct {
+	/* What the console shows, or will once the frame being drawn is
+	 * presented. Every write goes here, and to text memory as well if the
+	 * console is on screen, so text memory is only read once, to fill in
+	 * console 0 (see load_shadow()). */
+	cell_t shadow[CONSOLE_WIDTH * CONSOLE_HEIGHT];
+	int term_color;
+	int cursor_hidden;
+	/* What the cursor register holds, less the start of visible_page, or
+	 * would hold if the console were on screen */
+	int cursor;
+	/* The page the console shows, and the page output goes to: the same
+	 * page, except between console_begin_frame() and console_present() */
+	int visible_page;
+	int draw_page;
+	cell_t *draw_base;
+	/* Rows of the page that isn't being drawn on which may differ from the
+	 * shadow, so console_begin_frame() need only copy these */
+	unsigned int stale_rows;
+	/* Does visible_page hold what the console shows? Output while the
+	 * console is off screen only goes to the shadow. */
+	int resident;
+	scrollback_t history;
+	/* The rows a newline at the bottom scrolls, inclusive */
+	int scroll_top;
+	int scroll_bottom;
+	/* If non-NULL, where putbytes() writes instead of at the cursor */
+	window_t *window;
+	/* Where putbytes() is in an escape sequence, which may be split
+	 * across calls */
+	ansi_parser_t parser;
+	/* Does putbytes() output go to the serial line as well? */
+	int mirror;
+} vconsole_t;
+
+#define VCONSOLE_INIT(n,res) \
+	{ .term_color = DEFAULT_COLOR, .visible_page = CONSOLE_PAGE(n), \
+	  .draw_page = CONSOLE_PAGE(n), .draw_base = PAGE_ADDR(CONSOLE_PAGE(n)), \
+	  .stale_rows = ALL_ROWS, .resident = (res), \
+	  .scroll_bottom = CONSOLE_HEIGHT - 1 }
+
+#if NUM_VCONSOLES != 4
+#error "vcons needs an initializer per console"
+#endif
+
+/* Console 0 starts out with what's on screen at boot; the rest start blank
+ * and get their pages filled in when first shown */
+vconsole_t vcons[NUM_VCONSOLES] = {
+	VCONSOLE_INIT(0,1), VCONSOLE_INIT(1,0), VCONSOLE_INIT(2,0),
+	VCONSOLE_INIT(3,0)
+};
+
+/* The console output goes to, and the console on screen */
+vconsole_t *cur = &vcons[0];
+vconsole_t *fg = &vcons[0];
+
+int shadow_loaded = 0;
+
+void write_cursor_register(vconsole_t *vc);
+void render_view(vconsole_t *vc);
 
 int putbyte( char ch )
 {
+	putbytes(&ch,1);
+	return 0;
+}
 
-	int row,col;  /* For getting the curren cursor posotion */
+/* Prints a character, or acts on '\n', '\r' or '\b', at the cursor */
+void output_char( char ch )
+{
 
+	int row,col;  /* For getting the curren cursor posotion */
 
 	get_cursor(&row,&col); 
 
@@ -58,8 +150,6 @@ int putbyte( char ch )
 		print_char(ch,row,col);
   	inc_cursor_position(row,col);
   }
-
-  return 0; 
 }
 
 int get_actul_index(int row,int col)
@@ -73,39 +163,220 @@ int get_actul_index(int row,int col)
 void print_char(char ch,int row,int col)
 {
 	int index;
-	if(cursor_hidden)
+	if(cur->cursor_hidden)
 	{
 		index = get_actul_index(row,col);
 		row = index/80;
 		col = index%80;
 	}
-	*(char *)(CONSOLE_MEM_BASE + 2*(row*CONSOLE_WIDTH + col)) = ch; 
-	*(char *)(CONSOLE_MEM_BASE + 2*(row*CONSOLE_WIDTH + col) + 1) = term_color;
+	put_cell(row,col,MAKE_CELL(ch,cur->term_color));
 }
 
+/** @brief Writes len bytes of s at the cursor, acting on escape sequences
+ *
+ *  Runs of plain text go to the screen a row at a time, with the cursor
+ *  register written once per run; everything else is taken a byte at a
+ *  time. See do_csi() for the sequences understood. Output to a window
+ *  (see console_set_window()) isn't interpreted.
+ */
 void 
 putbytes( const char *s, int len )
 {
-	int i;
+	int i = 0, n;
 
-  for(i = 0; i < len; i++)
-  {
-  	putbyte(s[i]);
-  }
+	if(cur->mirror)
+		serial_write(s,len);
+
+	if(cur->window)
+	{
+		window_putbytes(cur->window,s,len);
+		return;
+	}
+
+	while(i < len)
+	{
+		if(cur->parser.state != ANSI_GROUND)
+		{
+			if(ansi_parse(&cur->parser,s[i++]) == ANSI_DONE)
+				do_csi(&cur->parser);
+			continue;
+		}
+
+		n = ansi_plain_run(s + i,len - i);
+		if(n > 0)
+		{
+			print_run(s + i,n);
+			i += n;
+		}
+		else if(s[i] == ANSI_ESC)
+		{
+			ansi_start(&cur->parser);
+			i++;
+		}
+		else
+			output_char(s[i++]);
+	}
+}
+
+/* The cursor's row and column on the screen, hidden or not */
+void cursor_cell(int *row,int *col)
+{
+	int index = read_cursor_index();
+
+	if(cur->cursor_hidden)
+		index = CURSOR_HIDE_SUB(index);
+	*row = index / CONSOLE_WIDTH;
+	*col = index % CONSOLE_WIDTH;
+}
+
+/* Prints len bytes with no special characters among them at the cursor,
+ * wrapping and scrolling as putbyte() does */
+void print_run(const char *s,int len)
+{
+	int row,col,n;
+
+	cursor_cell(&row,&col);
+	while(len > 0)
+	{
+		n = CONSOLE_WIDTH - col;
+		if(n > len)
+			n = len;
+		cells_span(SHADOW_PTR(row,col),s,n,cur->term_color);
+		console_sync_rect(row,col,1,n);
+		s += n;
+		len -= n;
+		col += n;
+
+		if(col == CONSOLE_WIDTH)
+		{
+			/* Off the end of the row: maybe a scroll */
+			adjust_cursor_position(get_cursor_location(row,0) + CONSOLE_WIDTH);
+			cursor_cell(&row,&col);
+		}
+	}
+	set_cursor(row,col);
+}
+
+/* Blanks an h x w rectangle at (row,col) in the current color */
+void erase_cells(int row,int col,int h,int w)
+{
+	if(h <= 0 || w <= 0)
+		return;
+	cells_fill(SHADOW_PTR(row,col),CONSOLE_WIDTH,h,w,BLANK_CELL);
+	console_sync_rect(row,col,h,w);
+}
+
+/* Acts on a CSI sequence. Rows and columns count from 1 and are clamped
+ * to the screen.
+ *
+ *   ESC [ n A/B/C/D     cursor up/down/right/left n
+ *   ESC [ r ; c H/f     cursor to row r, column c
+ *   ESC [ n J           erase to the end (0), from the start (1) or all (2)
+ *                       of the screen
+ *   ESC [ n K           the same for the cursor's row
+ *   ESC [ n S           scroll the scroll region up n rows
+ *   ESC [ t ; b r       scroll region rows t to b, and cursor home
+ *   ESC [ ... m         colors; see ansi_sgr()
+ *   ESC [ ? 25 l/h      hide/show the cursor
+ */
+void do_csi(const ansi_parser_t *p)
+{
+	int row,col,n;
+
+	if(p->private)
+	{
+		if(p->private == '?' && ansi_param(p,0,0) == 25)
+		{
+			if(p->final == 'l')
+				hide_cursor();
+			else if(p->final == 'h')
+				show_cursor();
+		}
+		return;
+	}
+
+	cursor_cell(&row,&col);
+	n = ansi_param(p,0,1);
+
+	switch(p->final)
+	{
+		case 'A':
+			set_cursor(CLAMP(row - n,0,CONSOLE_HEIGHT - 1),col);
+			break;
 
+		case 'B':
+			set_cursor(CLAMP(row + n,0,CONSOLE_HEIGHT - 1),col);
+			break;
+
+		case 'C':
+			set_cursor(row,CLAMP(col + n,0,CONSOLE_WIDTH - 1));
+			break;
+
+		case 'D':
+			set_cursor(row,CLAMP(col - n,0,CONSOLE_WIDTH - 1));
+			break;
+
+		case 'H':
+		case 'f':
+			set_cursor(CLAMP(n - 1,0,CONSOLE_HEIGHT - 1),
+			           CLAMP(ansi_param(p,1,1) - 1,0,CONSOLE_WIDTH - 1));
+			break;
+
+		case 'J':
+			n = ansi_param(p,0,0);
+			if(n == 0)
+			{
+				erase_cells(row,col,1,CONSOLE_WIDTH - col);
+				erase_cells(row + 1,0,CONSOLE_HEIGHT - row - 1,CONSOLE_WIDTH);
+			}
+			else if(n == 1)
+			{
+				erase_cells(0,0,row,CONSOLE_WIDTH);
+				erase_cells(row,0,1,col + 1);
+			}
+			else if(n == 2)
+				erase_cells(0,0,CONSOLE_HEIGHT,CONSOLE_WIDTH);
+			break;
+
+		case 'K':
+			n = ansi_param(p,0,0);
+			if(n == 0)
+				erase_cells(row,col,1,CONSOLE_WIDTH - col);
+			else if(n == 1)
+				erase_cells(row,0,1,col + 1);
+			else if(n == 2)
+				erase_cells(row,0,1,CONSOLE_WIDTH);
+			break;
+
+		case 'S':
+			n = CLAMP(n,0,cur->scroll_bottom - cur->scroll_top + 1);
+			while(n-- > 0)
+				scroll_console();
+			break;
+
+		case 'r':
+			if(console_set_scroll_region(n - 1,
+			                             ansi_param(p,1,CONSOLE_HEIGHT) - 1) == 0)
+				set_cursor(0,0);
+			break;
+
+		case 'm':
+			cur->term_color = ansi_sgr(p,cur->term_color,DEFAULT_COLOR);
+			break;
+	}
 }
 
 int
 set_term_color( int color )
 {
-	term_color = color;
+	cur->term_color = color;
   return 0;
 }
 
 void
 get_term_color( int *color )
 {
-	*color = term_color;
+	*color = cur->term_color;
 }
 
 int
@@ -121,11 +392,7 @@ set_cursor( int row, int col )
 void
 get_cursor( int *row, int *col )
 {
-	int temp;
-	outb(CRTC_IDX_REG,CRTC_CURSOR_LSB_IDX);
-	temp = inb(CRTC_DATA_REG);
-	outb(CRTC_IDX_REG,CRTC_CURSOR_MSB_IDX);
-	temp = (inb(CRTC_DATA_REG) << 8) | temp;
+	int temp = read_cursor_index();
 	*row = temp / CONSOLE_WIDTH;
 	*col = temp % CONSOLE_WIDTH;
 }
@@ -133,7 +400,9 @@ get_cursor( int *row, int *col )
 void
 hide_cursor()
 {
-	cursor_hidden = 1;
+	if(cur->cursor_hidden)
+		return;
+	cur->cursor_hidden = 1;
 	int row,col;
 	get_cursor(&row,&col);
   int index = GET_CURSOR_POS(row,col);
@@ -145,9 +414,9 @@ hide_cursor()
 void
 show_cursor()
 {
-	if(!cursor_hidden)
+	if(!cur->cursor_hidden)
 		return;
-	cursor_hidden = 0;
+	cur->cursor_hidden = 0;
 	int row,col;
 	int index;
 	get_cursor(&row,&col);
@@ -161,35 +430,51 @@ clear_console()
 {
 	int index = 0;
 	remove_characters();
-	if(cursor_hidden)
+	if(cur->cursor_hidden)
 		index = CONSOLE_WIDTH * CONSOLE_HEIGHT;
 	adjust_cursor_position(index);
 }
 
 void remove_characters()
 {
-	int i;
-	for(i = CONSOLE_MEM_BASE; i < CONSOLE_END; i+=2)
-	{
-		*(char *)i = 0x00;
-	}
+	load_shadow();
+	cells_fill(cur->shadow,CONSOLE_WIDTH,CONSOLE_HEIGHT,CONSOLE_WIDTH,
+	           MAKE_CELL(0,cur->term_color));
+	console_sync_rect(0,0,CONSOLE_HEIGHT,CONSOLE_WIDTH);
 }
 
 void
 draw_char( int row, int col, int ch, int color )
 {
-	*(char *)(CONSOLE_MEM_BASE + 2*(row*CONSOLE_WIDTH + col)) = ch; 
-	*(char *)(CONSOLE_MEM_BASE + 2*(row*CONSOLE_WIDTH + col) + 1) = color;
+	put_cell(row,col,MAKE_CELL(ch,color));
 }
 
 char
 get_char( int row, int col )
 {
-	char ch;
+	return CELL_CHAR(get_cell(row,col));
+}
 
-	ch = *(char *)(CONSOLE_MEM_BASE + 2*(row*CONSOLE_WIDTH + col)); 
-  return ch; 
+/** @brief Returns the character and color at (row,col) as one cell, or a
+ *         blank cell in the current color if that's off the screen */
+cell_t
+get_cell( int row, int col )
+{
+	if(row < 0 || row >= CONSOLE_HEIGHT || col < 0 || col >= CONSOLE_WIDTH)
+		return BLANK_CELL;
+	load_shadow();
+	return *SHADOW_PTR(row,col);
+}
 
+/** @brief Copies the whole screen, row by row, into buf
+ *
+ *  @param buf room for CONSOLE_WIDTH * CONSOLE_HEIGHT cells
+ */
+void
+console_snapshot( cell_t *buf )
+{
+	load_shadow();
+	memcpy(buf,cur->shadow,sizeof(cur->shadow));
 }
 
 int check_special_characters(char ch,int row,int col)
@@ -209,8 +494,12 @@ int check_special_characters(char ch,int row,int col)
 			break;
 
 		case '\b':
-		  print_char(' ',row,col - 1);
-		  dcr_cursor_position(row,col);
+			/* Backspace doesn't go back past the start of the row */
+			if(col > 0)
+			{
+				print_char(' ',row,col - 1);
+				dcr_cursor_position(row,col);
+			}
 			special_char_flag = SUCCESS;
 			break;
 
@@ -247,24 +536,22 @@ void dcr_cursor_position(int row,int col)
 	adjust_cursor_position(index);
 }
 
+/* Moving off the bottom of the scroll region scrolls it, leaving the
+ * cursor at the start of its last row. Moving off the bottom of the screen
+ * below the region leaves the cursor at the start of the last row. */
 void adjust_cursor_position(int index)
 {
-	if(cursor_hidden)
+	int hide = cur->cursor_hidden ? CURSOR_HIDE_CONSTANT : 0;
+	int row = (index - hide) / CONSOLE_WIDTH;
+
+	if(row == cur->scroll_bottom + 1)
 	{
-		if(index >= 2 * (CONSOLE_WIDTH * CONSOLE_HEIGHT))
-		{
-			scroll_console();
-			index = SCROLL_CONSOLE_BUFFER_LENGTH + CONSOLE_WIDTH;
-		}
+		scroll_console();
+		index = hide + cur->scroll_bottom * CONSOLE_WIDTH;
 	}
-
-	else
+	else if(row >= CONSOLE_HEIGHT)
 	{
-		if(index >= (CONSOLE_WIDTH * CONSOLE_HEIGHT))
-		{
-			scroll_console();
-			index = CONSOLE_WIDTH * (CONSOLE_HEIGHT - 1);
-		}
+		index = hide + (CONSOLE_HEIGHT - 1) * CONSOLE_WIDTH;
 	}
 
 	send_data_IO_port(index);
@@ -274,42 +561,407 @@ int get_cursor_location(int row,int col)
 {
 	int index = GET_CURSOR_POS(row,col);
 
-	if(!cursor_hidden)
+	if(!cur->cursor_hidden)
 		return index;
 	else
 		return CURSOR_HIDE_ADD(index);
 }
 
+/* Each console keeps its own cursor, so the cursor register is only read
+ * once, at boot */
+int read_cursor_index()
+{
+	load_shadow();
+	return cur->cursor;
+}
+
 void send_data_IO_port(int index)
 {
+	cur->cursor = index;
+	if(ON_SCREEN)
+		write_cursor_register(cur);
+}
+
+/* The cursor register counts from the start of text memory, not of the
+ * page on screen; the rest of the driver counts from the page */
+void write_cursor_register(vconsole_t *vc)
+{
+	int index = vc->cursor + vc->visible_page * PAGE_CELLS;
+
 	outb(CRTC_IDX_REG,CRTC_CURSOR_LSB_IDX);
 	outb(CRTC_DATA_REG,index % IO_PORT_WIDTH);
 	outb(CRTC_IDX_REG,CRTC_CURSOR_MSB_IDX);
 	outb(CRTC_DATA_REG,index / IO_PORT_WIDTH);
 }
 
+/* Shows the page starting at the given cell of text memory */
+void write_start_register(int page)
+{
+	unsigned int start = page * PAGE_CELLS;
+
+	outb(CRTC_IDX_REG,CRTC_START_LSB_IDX);
+	outb(CRTC_DATA_REG,start % IO_PORT_WIDTH);
+	outb(CRTC_IDX_REG,CRTC_START_MSB_IDX);
+	outb(CRTC_DATA_REG,start / IO_PORT_WIDTH);
+}
+
+/* Moves the lines of the scroll region up in the shadow, where reading is
+ * cheap, and then rewrites them in text memory. The top line of the screen
+ * goes into the scrollback. */
 void scroll_console()
 {
-	scroll_console_buffer = malloc(SCROLL_CONSOLE_BUFFER_LENGTH);
+	int top = cur->scroll_top, bottom = cur->scroll_bottom;
+
+	load_shadow();
+	if(top == 0)
+		scrollback_push(&cur->history,cur->shadow);
+	memmove(SHADOW_PTR(top,0),SHADOW_PTR(top + 1,0),
+	        (bottom - top) * CONSOLE_WIDTH * sizeof(cell_t));
+	clear_console_row(bottom);
+	console_sync_rect(top,0,bottom - top + 1,CONSOLE_WIDTH);
+}
 
-	char *mem_area_second_row = (char *) GET_NEXT_ROW(CONSOLE_MEM_BASE);
-	char *mem_area_start = (char *)CONSOLE_MEM_BASE;
+/** @brief Limits scrolling to rows top to bottom, inclusive
+ *
+ *  The rows outside stay put when output runs off the bottom of the region.
+ *
+ *  @return 0, or -1 if the rows aren't on the screen
+ */
+int console_set_scroll_region( int top, int bottom )
+{
+	if(top < 0 || bottom >= CONSOLE_HEIGHT || top > bottom)
+		return -1;
+	cur->scroll_top = top;
+	cur->scroll_bottom = bottom;
+	return 0;
+}
 
-	memcpy(scroll_console_buffer,mem_area_second_row,
-		     SCROLL_CONSOLE_BUFFER_LENGTH);
-	memcpy(mem_area_start,scroll_console_buffer,
-		     SCROLL_CONSOLE_BUFFER_LENGTH);
-	free(scroll_console_buffer);
-	
-	unsigned int mem_area_lastrow = GET_LAST_ROW(CONSOLE_MEM_BASE);
-	clear_console_row(mem_area_lastrow);
+/** @brief Copies the console's putbytes() and putbyte() output, escape
+ *         sequences and all, to the serial line, or stops
+ */
+void console_set_mirror( int on )
+{
+	cur->mirror = on;
+}
+
+/** @brief Sends putbytes() and putbyte() output into a window, or back to
+ *         the cursor if win is NULL
+ */
+void console_set_window( window_t *win )
+{
+	cur->window = win;
+}
+
+/* Blanks a row of the shadow; the caller syncs it */
+void clear_console_row(int row)
+{
+	cells_fill(SHADOW_PTR(row,0),CONSOLE_WIDTH,1,CONSOLE_WIDTH,
+	           MAKE_CELL(0,cur->term_color));
+}
+
+/* Fills in console 0 from the screen and the cursor register the first
+ * time the driver is used, so whatever the boot loader left there reads
+ * back */
+void load_shadow()
+{
+	int temp;
+
+	if(shadow_loaded)
+		return;
+	shadow_loaded = 1;
+
+	memcpy(vcons[0].shadow,PAGE_ADDR(0),sizeof(vcons[0].shadow));
+	outb(CRTC_IDX_REG,CRTC_CURSOR_LSB_IDX);
+	temp = inb(CRTC_DATA_REG);
+	outb(CRTC_IDX_REG,CRTC_CURSOR_MSB_IDX);
+	temp = (inb(CRTC_DATA_REG) << 8) | temp;
+	vcons[0].cursor = temp;
+}
+
+/* Writes one cell to the shadow, and to the page being drawn on if the
+ * console is on screen. Cells off the screen are ignored. */
+void put_cell(int row,int col,cell_t cell)
+{
+	if(row < 0 || row >= CONSOLE_HEIGHT || col < 0 || col >= CONSOLE_WIDTH)
+		return;
+	load_shadow();
+	*SHADOW_PTR(row,col) = cell;
+	cur->stale_rows |= ROW_MASK(row,1);
+	if(!ON_SCREEN)
+	{
+		cur->resident = 0;
+		return;
+	}
+	if(cur->history.offset)
+		leave_history();
+	*CELL_PTR(row,col) = cell;
+}
+
+/* Copies an h x w rectangle at (row,col) of the shadow to the page being
+ * drawn on, if the console is on screen. The other page is now behind in
+ * those rows. */
+void console_sync_rect(int row,int col,int h,int w)
+{
+	cur->stale_rows |= ROW_MASK(row,h);
+	if(!ON_SCREEN)
+	{
+		cur->resident = 0;
+		return;
+	}
+	if(cur->history.offset)
+		leave_history();
+	cells_copy(CELL_PTR(row,col),CONSOLE_WIDTH,SHADOW_PTR(row,col),
+	           CONSOLE_WIDTH,h,w);
 }
 
-void clear_console_row(unsigned int addr)
+/** @brief Starts drawing a frame off screen
+ *
+ *  Until console_present(), all output goes to a page of text memory that
+ *  isn't on screen. The page starts as a copy of the screen, so a frame
+ *  need only draw what changed; it already holds the frame before last, so
+ *  only the rows changed since then are copied from the shadow.
+ */
+void console_begin_frame()
 {
-	unsigned int i;
-	for(i = addr; i < addr + CONSOLE_WIDTH; i+=2)
+	int row;
+
+	load_shadow();
+	if(cur->draw_page != cur->visible_page)
+		return;
+	cur->draw_page = cur->visible_page ^ 1;
+	cur->draw_base = PAGE_ADDR(cur->draw_page);
+	if(!ON_SCREEN)
 	{
-		*(char *)i = 0x00;
+		cur->resident = 0;
+		return;
 	}
+	if(cur->history.offset)
+		leave_history();
+	for(row = 0; row < CONSOLE_HEIGHT; row++)
+		if(cur->stale_rows & ROW_MASK(row,1))
+			cells_copy(CELL_PTR(row,0),CONSOLE_WIDTH,SHADOW_PTR(row,0),
+			           CONSOLE_WIDTH,1,CONSOLE_WIDTH);
+	cur->stale_rows = 0;
+}
+
+/** @brief Puts the frame drawn since console_begin_frame() on screen
+ *
+ *  Only the display start address changes, so the whole frame appears at
+ *  once, and the cursor moves with it.
+ */
+void console_present()
+{
+	cur->visible_page = cur->draw_page;
+	if(ON_SCREEN)
+	{
+		write_start_register(cur->visible_page);
+		write_cursor_register(cur);
+	}
+}
+
+/** @brief Sends output to console n, which need not be on screen
+ *
+ *  Output to a console off screen only goes to its shadow, and reaches
+ *  text memory when the console is next shown.
+ *
+ *  @return the console output went to before, or -1 if there is no
+ *          console n
+ */
+int console_select( int n )
+{
+	int prev = cur - vcons;
+
+	if(n < 0 || n >= NUM_VCONSOLES)
+		return -1;
+	cur = &vcons[n];
+	return prev;
+}
+
+/** @brief Puts console n on screen
+ *
+ *  If the console's page still holds what it shows, only the display start
+ *  address changes; otherwise the page is first rewritten from the shadow
+ *  in one copy, as is the page a frame is being drawn on, if any.
+ *
+ *  @return 0, or -1 if there is no console n
+ */
+int console_switch( int n )
+{
+	vconsole_t *vc;
+
+	if(n < 0 || n >= NUM_VCONSOLES)
+		return -1;
+	load_shadow();
+	vc = &vcons[n];
+	if(vc == fg)
+		return 0;
+
+	/* Its page shows history, so it needs rewriting when it comes back */
+	if(fg->history.offset)
+	{
+		fg->history.offset = 0;
+		fg->resident = 0;
+	}
+
+	if(!vc->resident)
+	{
+		cells_copy(PAGE_ADDR(vc->visible_page),CONSOLE_WIDTH,
+		           vc->shadow,CONSOLE_WIDTH,CONSOLE_HEIGHT,CONSOLE_WIDTH);
+		vc->resident = 1;
+		vc->stale_rows = ALL_ROWS;
+
+		/* Part way through a frame, the page being drawn on missed the
+		 * output too, and what's drawn next goes on top of it */
+		if(vc->draw_page != vc->visible_page)
+		{
+			cells_copy(vc->draw_base,CONSOLE_WIDTH,vc->shadow,CONSOLE_WIDTH,
+			           CONSOLE_HEIGHT,CONSOLE_WIDTH);
+			vc->stale_rows = 0;
+		}
+	}
+	fg = vc;
+	write_start_register(vc->visible_page);
+	write_cursor_register(vc);
+	return 0;
+}
+
+/** @brief Shows the console on screen offset lines back into its history
+ *
+ *  The top offset rows show history and the rest show the top of the live
+ *  screen. The offset is clamped to the history there is; 0 is the live
+ *  screen, which any output to the console goes back to.
+ *
+ *  @return the offset shown
+ */
+int console_view( int offset )
+{
+	offset = scrollback_clamp(&fg->history,offset);
+	if(offset != fg->history.offset)
+	{
+		fg->history.offset = offset;
+		render_view(fg);
+	}
+	return offset;
+}
+
+/** @brief Moves the view lines further back into history, or forwards if
+ *         lines is negative
+ *
+ *  @return the offset shown
+ */
+int console_scroll_view( int lines )
+{
+	return console_view(fg->history.offset + lines);
+}
+
+/* Composes the view of a console on screen onto its visible page: history
+ * above, then the live screen below it */
+void render_view(vconsole_t *vc)
+{
+	cell_t *page = PAGE_ADDR(vc->visible_page);
+	int offset = vc->history.offset;
+	int row;
+
+	for(row = 0; row < offset && row < CONSOLE_HEIGHT; row++)
+		cells_copy(page + row * CONSOLE_WIDTH,CONSOLE_WIDTH,
+		           scrollback_line(&vc->history,offset - row),CONSOLE_WIDTH,
+		           1,CONSOLE_WIDTH);
+	if(row < CONSOLE_HEIGHT)
+		cells_copy(page + row * CONSOLE_WIDTH,CONSOLE_WIDTH,vc->shadow,
+		           CONSOLE_WIDTH,CONSOLE_HEIGHT - row,CONSOLE_WIDTH);
+}
+
+/* Puts the live screen back on the current console, which is on screen */
+void leave_history()
+{
+	cur->history.offset = 0;
+	render_view(cur);
+}
+
+/** @brief Sets aside memory for the consoles' history */
+void console_init()
+{
+	int i;
+	int lines = scrollback_lines(NUM_VCONSOLES);
+
+	for(i = 0; i < NUM_VCONSOLES; i++)
+		scrollback_init(&vcons[i].history,lines);
+}
+
+/* Clips an h x w rectangle at (row,col) to the screen. Returns how far
+ * into a source with the given stride its first visible cell is, or -1 if
+ * none of it is visible. */
+int clip_rect(int *row,int *col,int *h,int *w,int stride)
+{
+	int skip = 0;
+
+	if(*row < 0)
+	{
+		skip -= *row * stride;
+		*h += *row;
+		*row = 0;
+	}
+	if(*col < 0)
+	{
+		skip -= *col;
+		*w += *col;
+		*col = 0;
+	}
+	if(*h > CONSOLE_HEIGHT - *row)
+		*h = CONSOLE_HEIGHT - *row;
+	if(*w > CONSOLE_WIDTH - *col)
+		*w = CONSOLE_WIDTH - *col;
+
+	if(*h <= 0 || *w <= 0)
+		return -1;
+	return skip;
+}
+
+/* Where the cell at (row,col) is in the shadow. Whoever writes through
+ * this must console_sync_rect() the cells they changed. */
+cell_t *console_shadow_ptr(int row,int col)
+{
+	load_shadow();
+	return SHADOW_PTR(row,col);
+}
+
+/** @brief Draws len characters of s in one color from (row,col) rightwards
+ *
+ *  Characters off the screen are dropped; nothing wraps.
+ */
+void draw_span( int row, int col, const char *s, int len, int color )
+{
+	int h = 1;
+	int skip = clip_rect(&row,&col,&h,&len,0);
+
+	if(skip < 0)
+		return;
+	load_shadow();
+	cells_span(SHADOW_PTR(row,col),s + skip,len,color);
+	console_sync_rect(row,col,1,len);
+}
+
+/** @brief Fills the h x w rectangle at (row,col) with one character */
+void fill_rect( int row, int col, int h, int w, int ch, int color )
+{
+	if(clip_rect(&row,&col,&h,&w,0) < 0)
+		return;
+	load_shadow();
+	cells_fill(SHADOW_PTR(row,col),CONSOLE_WIDTH,h,w,MAKE_CELL(ch,color));
+	console_sync_rect(row,col,h,w);
+}
+
+/** @brief Draws an h x w rectangle of packed cells at (row,col)
+ *
+ *  @param stride cells from the start of one row of cells to the next
+ */
+void blit_cells( int row, int col, int h, int w, const cell_t *cells, int stride )
+{
+	int skip = clip_rect(&row,&col,&h,&w,stride);
+
+	if(skip < 0)
+		return;
+	load_shadow();
+	cells_copy(SHADOW_PTR(row,col),CONSOLE_WIDTH,cells + skip,stride,h,w);
+	console_sync_rect(row,col,h,w);
 }
@@ -10,8 +10,26 @@
 #ifndef __CONSOLE_DEVICE_DRIVER_H
 #define __CONSOLE_DEVICE_DRIVER_H
 
+#include <console_cells.h>
+#include <scrollback.h>
+#include <window.h>
+#include <ansi.h>
+
+/* Consoles output can go to; only one is on screen at a time */
+#define NUM_VCONSOLES 4
+
+void output_char( char ch );
+
 void print_char(char ch,int row,int col);
 
+void cursor_cell(int *row,int *col);
+
+void print_run(const char *s,int len);
+
+void erase_cells(int row,int col,int h,int w);
+
+void do_csi(const ansi_parser_t *p);
+
 int check_special_characters(char ch,int row,int col);
 
 void inc_cursor_position(int row,int col);
@@ -32,8 +50,53 @@ void remove_characters();
 
 void scroll_console();
 
-void clear_console_row(unsigned int addr);
+void clear_console_row(int row);
+
+void load_shadow();
+
+void put_cell(int row,int col,cell_t cell);
+
+void console_sync_rect(int row,int col,int h,int w);
+
 
 int get_actul_index(int row,int col);
 
+int read_cursor_index();
+
+void console_begin_frame();
+
+void console_present();
+
+int console_select( int n );
+
+int console_switch( int n );
+
+int console_view( int offset );
+
+int console_scroll_view( int lines );
+
+void leave_history();
+
+void console_init();
+
+int console_set_scroll_region( int top, int bottom );
+
+void console_set_window( window_t *win );
+
+void console_set_mirror( int on );
+
+int clip_rect(int *row,int *col,int *h,int *w,int stride);
+
+cell_t *console_shadow_ptr(int row,int col);
+
+cell_t get_cell( int row, int col );
+
+void console_snapshot( cell_t *buf );
+
+void draw_span( int row, int col, const char *s, int len, int color );
+
+void fill_rect( int row, int col, int h, int w, int ch, int color );
+
+void blit_cells( int row, int col, int h, int w, const cell_t *cells, int stride );
+
 #endif
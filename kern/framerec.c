@@ -0,0 +1,156 @@
+/** @file framerec.c
+ *
+ *  @brief Run-length diffs between console frames
+ *
+ *  framerec_diff() writes what changed from one frame to the next in the
+ *  format described in framerec.h, and framerec_apply() plays it back onto
+ *  a copy of the earlier frame. Frames are CONSOLE_HEIGHT rows of
+ *  CONSOLE_WIDTH cells. Nothing here touches the screen, so the same code
+ *  records in the kernel and decodes on the build machine.
+ *
+ *  @bug No known bugs
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <framerec.h>
+
+#define CHANGED(prev,next,col) ((prev) == NULL || (prev)[col] != (next)[col])
+
+/* Are two rows the same? A row is a whole number of words, so this
+ * compares two cells at a time, which memcmp() here doesn't */
+int framerec_same_row(const cell_t *a, const cell_t *b)
+{
+	const uint32_t *x = (const uint32_t *)a, *y = (const uint32_t *)b;
+	int i;
+
+	for(i = 0; i < CONSOLE_WIDTH / 2; i++)
+		if(x[i] != y[i])
+			return 0;
+	return 1;
+}
+
+/* Writes the spans of one row that differ between prev and next, or the
+ * whole row if prev is NULL, and returns where the output ends */
+unsigned char *framerec_row(const cell_t *prev, const cell_t *next,
+                            unsigned char *out)
+{
+	int col = 0, start, end, i;
+	int color, run;
+
+	while(col < CONSOLE_WIDTH)
+	{
+		if(!CHANGED(prev,next,col))
+		{
+			col++;
+			continue;
+		}
+
+		/* Stretch the span while the next change is close enough */
+		start = col;
+		end = col + 1;
+		for(i = end; i < CONSOLE_WIDTH && i <= end + FR_MERGE_GAP; i++)
+			if(CHANGED(prev,next,i))
+				end = i + 1;
+
+		*out++ = start;
+		*out++ = end - start;
+		for(i = start; i < end; i++)
+			*out++ = CELL_CHAR(next[i]);
+		for(i = start; i < end; i += run)
+		{
+			color = CELL_COLOR(next[i]);
+			for(run = 1; i + run < end && CELL_COLOR(next[i + run]) == color; run++)
+				continue;
+			*out++ = run;
+			*out++ = color;
+		}
+		col = end;
+	}
+	return out;
+}
+
+/** @brief Encodes the changes from prev to next
+ *
+ *  @param prev the frame before, or NULL for a frame that stands alone
+ *  @param out room for FR_MAX_FRAME bytes
+ *  @return the bytes written
+ */
+int framerec_diff(const cell_t *prev, const cell_t *next, unsigned char *out)
+{
+	unsigned char *p = out;
+	const cell_t *prev_row = NULL;
+	int row;
+
+	*p++ = FR_FRAME;
+	for(row = 0; row < CONSOLE_HEIGHT; row++)
+	{
+		if(prev != NULL)
+		{
+			prev_row = prev + row * CONSOLE_WIDTH;
+			if(framerec_same_row(prev_row,next + row * CONSOLE_WIDTH))
+				continue;
+		}
+		*p++ = row;
+		p = framerec_row(prev_row,next + row * CONSOLE_WIDTH,p);
+		*p++ = FR_END;
+	}
+	*p++ = FR_END;
+	return p - out;
+}
+
+/** @brief Applies one encoded frame to screen
+ *
+ *  @return the bytes of in the frame took, or -1 if in doesn't start with
+ *          a whole, well-formed frame; screen may then be partly updated
+ */
+int framerec_apply(cell_t *screen, const unsigned char *in, int len)
+{
+	const unsigned char *p = in, *end = in + len;
+	cell_t *cells;
+	int row, col, n, i, k, run;
+
+	if(len < 1 || *p++ != FR_FRAME)
+		return -1;
+
+	for(;;)
+	{
+		if(p == end)
+			return -1;
+		row = *p++;
+		if(row == FR_END)
+			return p - in;
+		if(row >= CONSOLE_HEIGHT)
+			return -1;
+
+		for(;;)
+		{
+			if(p == end)
+				return -1;
+			col = *p++;
+			if(col == FR_END)
+				break;
+			if(p == end)
+				return -1;
+			n = *p++;
+			if(col >= CONSOLE_WIDTH || n == 0 || n > CONSOLE_WIDTH - col ||
+			   end - p < n)
+				return -1;
+
+			cells = screen + row * CONSOLE_WIDTH + col;
+			for(i = 0; i < n; i++)
+				cells[i] = *p++;
+			for(i = 0; i < n; i += run)
+			{
+				if(end - p < 2)
+					return -1;
+				run = p[0];
+				if(run == 0 || run > n - i)
+					return -1;
+				for(k = i; k < i + run; k++)
+					cells[k] |= MAKE_CELL(0,p[1]);
+				p += 2;
+			}
+		}
+	}
+}
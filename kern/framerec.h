@@ -0,0 +1,30 @@
+/** @file framerec.h
+ *  @brief Encoding the changes between console frames
+ *
+ *  A frame is FR_FRAME, then for each row that changed, the row number
+ *  and its spans, then FR_END. A span is its starting column and length,
+ *  the characters, and the colors as (count, color) runs covering it; a
+ *  row's spans end with FR_END. Unchanged cells between changes close
+ *  together are sent rather than starting a new span.
+ */
+
+#ifndef __FRAMEREC_H
+#define __FRAMEREC_H
+
+#include <video_defines.h>
+#include <console_cells.h>
+
+#define FR_FRAME 0xFE   /* starts a frame */
+#define FR_END   0xFF   /* ends a row's spans, or a frame's rows */
+
+/* Changed cells this few apart go in one span */
+#define FR_MERGE_GAP 3
+
+/* Most bytes a frame takes: every row one span, every cell its own color */
+#define FR_MAX_FRAME (2 + CONSOLE_HEIGHT * (4 + 3 * CONSOLE_WIDTH))
+
+int framerec_diff(const cell_t *prev, const cell_t *next, unsigned char *out);
+
+int framerec_apply(cell_t *screen, const unsigned char *in, int len);
+
+#endif
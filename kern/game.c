@@ -77,4 +77,5 @@ int kernel_main(mbinfo_t *mbinfo, int argc, char **argv, char **envp)
  **/
 void tick(unsigned int numTicks)
 {
+    sim_log_tick(numTicks);
 }
@@ -16,7 +16,11 @@
 #include <keyhelp.h>
 #include <install_handlers.h>
 #include <interrupt_handler_wrappers.h>
+#include <video_defines.h>
+#include <console_device_driver.h>
+#include <serial.h>
 #include <asm.h>       /* register manipulation */
+#include <eflags.h>
 #include <simics.h>    /* Sim breakpoints */
 
 #define BUFFER_MAX_SLOTS 100
@@ -31,6 +35,12 @@
 
 #define TIMER_INTERRUPT_INTERVAL 0.01
 
+#define SERIAL_BAUD 115200
+
+/* Lines page up and page down move the console back through its history;
+ * one line stays on screen from the page before */
+#define SCROLLBACK_PAGE (CONSOLE_HEIGHT - 1)
+
 void (*fptr)(unsigned int);
 SharedBuffer sbuf;
 unsigned int numTicks = 0;
@@ -41,6 +51,9 @@ int handler_install(void (*tickback)(unsigned int))
 	 install_timer_handler(tickback);
 	 install_keyboard_handler();
 	 sbuf_init(BUFFER_MAX_SLOTS);
+	 console_init();
+	 if(serial_init(SERIAL_BAUD) == 0)
+		 install_serial_handler();
  	 return 0;
 }
 
@@ -52,9 +65,15 @@ void sbuf_init(int num_slots)
   sbuf->front = sbuf->rear = 0;        
 }
 
+/* The keyboard and serial handlers both insert, and are trap gates, so
+ * one can interrupt the other between reading rear and writing it back */
 void sbuf_insert(int item)
 {
+	uint32_t eflags = get_eflags();
+
+	disable_interrupts();
 	sbuf->buf[sbuf->rear++ % (sbuf->num_slots)] = item;
+	set_eflags(eflags);
 }
 
 int sbuf_remove()
@@ -72,14 +91,48 @@ int readchar(void)
 	kh_type augmented_ch;
 
 	item = sbuf_remove();
+
+	/* Bytes from the serial line are characters already. A terminal sends
+	 * '\r' for Enter, where the keyboard gives '\n'. */
+	if(item & SERIAL_INPUT)
+	{
+		item &= 0xFF;
+		return item == '\r' ? '\n' : item;
+	}
+
 	augmented_ch = process_scancode(item);
 
+	if(scrollback_key(augmented_ch))
+		return -1;
+
 	item = convert_aug_char(augmented_ch);
 
 	return item;
 
 }
 
+/* Page up and page down belong to the console: they scroll through its
+ * history rather than reaching the caller */
+int scrollback_key(kh_type aug_char)
+{
+	if(!KH_HASDATA(aug_char))
+		return 0;
+
+	switch(KH_GETCHAR(aug_char))
+	{
+		case KHE_PAGE_UP:
+			if(KH_ISMAKE(aug_char))
+				console_scroll_view(SCROLLBACK_PAGE);
+			return 1;
+
+		case KHE_PAGE_DOWN:
+			if(KH_ISMAKE(aug_char))
+				console_scroll_view(-SCROLLBACK_PAGE);
+			return 1;
+	}
+	return 0;
+}
+
 int convert_aug_char(kh_type aug_char)
 {
 	if(KH_HASDATA(aug_char))
@@ -133,6 +186,19 @@ void install_keyboard_handler()
 
 }
 
+void install_serial_handler()
+{
+	 void *idt_base_addr = idt_base();
+ 	 unsigned int serial_IDT_addr = GET_IDT_ADDR(idt_base_addr,COM1_IDT_ENTRY);
+ 	 unsigned int serial_handler_addr = (unsigned int)&serial_handler_wrapper;
+ 	 unsigned int serial_handler_lowaddr = GET_LOWER_NIBBLE(serial_handler_addr);
+ 	 unsigned int serial_handler_highaddr = GET_UPPER_NIBBLE(serial_handler_addr);
+ 	 unsigned int make_LSB_entry = PACK_LSB_IDT_ENTRY(SEGSEL_KERNEL_CS,serial_handler_lowaddr);
+ 	 unsigned int make_MSB_entry = PACK_MSB_IDT_ENTRY(serial_handler_highaddr,0x00008F00);
+ 	 PUT_VAL_IDT_LSB(serial_IDT_addr,make_LSB_entry);
+ 	 PUT_VAL_IDT_MSB(serial_IDT_addr,make_MSB_entry);
+}
+
 void keyboard_C_handler()
 {
 	lprintf("Keyboard handler");
@@ -11,7 +11,7 @@
 #define __INSTALL_HANDLERS_H
 
 typedef struct {
-  char *buf;                 /* Buffer array */         
+  int *buf;                  /* Buffer array */         
   int num_slots;                     /* Maximum number of slots */
   volatile int front;        /* buf[(front+1)%num_slots] is first item */
   volatile int rear;         /* buf[rear%num_slts] is last item */
@@ -22,10 +22,12 @@ typedef sbuf_t* SharedBuffer;
 void sbuf_init(int num_slots);
 void sbuf_insert(int item);
 int sbuf_remove();
+int scrollback_key(kh_type aug_char);
 int convert_aug_char(kh_type aug_char);
 void install_timer_handler(void *tickback);
 void timer_C_handler();
 void install_keyboard_handler();
+void install_serial_handler();
 void keyboard_C_handler();
 
 #endif
@@ -13,5 +13,6 @@
 
 void timer_handler_wrapper();
 void keyboard_handler_wrapper();
+void serial_handler_wrapper();
 
 #endif
\ No newline at end of file
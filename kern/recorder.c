@@ -0,0 +1,124 @@
+/** @file recorder.c
+ *
+ *  @brief Console frame recorder
+ *  Each call to recorder_frame() takes a snapshot of the console output
+ *  goes to and sends how it differs from the last one, encoded by
+ *  framerec_diff(), to the sink. A frame goes whole or not at all: if the
+ *  sink has no room, the frame is dropped and the next one is sent in
+ *  full, so whoever decodes the stream never falls out of step.
+ *
+ *  @bug No known bugs
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <video_defines.h>
+#include <console_device_driver.h>
+#include <framerec.h>
+#include <serial.h>
+#include <recorder.h>
+
+#define RING_MASK (RECORD_RING_SIZE - 1)
+
+/* A frame goes whole or not at all, so a sink that can't hold the largest
+ * would drop every frame from the first that big on */
+#if FR_MAX_FRAME > SERIAL_TX_SIZE || FR_MAX_FRAME > RECORD_RING_SIZE
+#error "every sink must have room for FR_MAX_FRAME bytes"
+#endif
+
+int record_sink = 0;
+
+/* The last frame sent, and the one being taken */
+cell_t record_frames[2][CONSOLE_WIDTH * CONSOLE_HEIGHT];
+cell_t *record_prev = record_frames[0];
+cell_t *record_next = record_frames[1];
+int record_have_prev = 0;
+unsigned int record_dropped = 0;
+
+unsigned char record_out[FR_MAX_FRAME];
+
+unsigned char record_ring[RECORD_RING_SIZE];
+volatile unsigned int ring_head = 0;   /* next byte to read */
+volatile unsigned int ring_tail = 0;   /* where the next byte goes */
+
+/** @brief Starts recording to RECORD_RING or RECORD_SERIAL; the first frame
+ *         is sent in full */
+void recorder_start(int sink)
+{
+	record_sink = sink;
+	record_have_prev = 0;
+	ring_head = ring_tail = 0;
+}
+
+void recorder_stop()
+{
+	record_sink = 0;
+}
+
+/* Sends len bytes to the sink if they all fit. Returns 0, or -1 if they
+ * don't. */
+int record_send(const unsigned char *buf, int len)
+{
+	unsigned int tail = ring_tail;
+	int i;
+
+	if(record_sink == RECORD_SERIAL)
+	{
+		if(serial_room() < len)
+			return -1;
+		serial_write((const char *)buf,len);
+		return 0;
+	}
+
+	if(RECORD_RING_SIZE - (tail - ring_head) < len)
+		return -1;
+	for(i = 0; i < len; i++)
+		record_ring[tail++ & RING_MASK] = buf[i];
+	ring_tail = tail;
+	return 0;
+}
+
+/** @brief Records a frame of the console output goes to
+ *
+ *  @return the bytes sent, 0 if not recording, or -1 if the sink had no
+ *          room and the frame was dropped
+ */
+int recorder_frame()
+{
+	cell_t *swap;
+	int len;
+
+	if(!record_sink)
+		return 0;
+
+	console_snapshot(record_next);
+	len = framerec_diff(record_have_prev ? record_prev : NULL,record_next,
+	                    record_out);
+	if(record_send(record_out,len) < 0)
+	{
+		record_dropped++;
+		record_have_prev = 0;
+		return -1;
+	}
+
+	swap = record_prev;
+	record_prev = record_next;
+	record_next = swap;
+	record_have_prev = 1;
+	return len;
+}
+
+/** @brief Takes up to max bytes of recorded frames from the ring
+ *
+ *  @return the bytes taken
+ */
+int recorder_read(unsigned char *buf, int max)
+{
+	unsigned int head = ring_head;
+	int i;
+
+	for(i = 0; i < max && head != ring_tail; i++)
+		buf[i] = record_ring[head++ & RING_MASK];
+	ring_head = head;
+	return i;
+}
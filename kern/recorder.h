@@ -0,0 +1,23 @@
+/** @file recorder.h
+ *  @brief Recording what the console shows, frame by frame
+ */
+
+#ifndef __RECORDER_H
+#define __RECORDER_H
+
+/* Where recorded frames go */
+#define RECORD_RING   1      /* a ring, emptied with recorder_read() */
+#define RECORD_SERIAL 2      /* COM1 */
+
+/* Bytes of frames the ring holds; a power of two */
+#define RECORD_RING_SIZE 16384
+
+void recorder_start(int sink);
+
+void recorder_stop();
+
+int recorder_frame();
+
+int recorder_read(unsigned char *buf, int max);
+
+#endif
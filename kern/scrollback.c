@@ -0,0 +1,90 @@
+/** @file scrollback.c
+ *
+ *  @brief Console scrollback
+ *  Each line scroll_console() pushes off the top of a console is copied
+ *  into that console's ring of lines, overwriting the oldest once the ring
+ *  is full, so keeping history costs one line's copy per scroll however
+ *  long it is. The console driver composes the view from the ring and the
+ *  live screen (see console_view()).
+ *
+ *  @bug No known bugs
+ */
+
+#include <stddef.h>
+#include <malloc.h>
+#include <video_defines.h>
+#include <string.h>
+#include <scrollback.h>
+
+#define LINE_BYTES (CONSOLE_WIDTH * sizeof(cell_t))
+
+#define RING_LINE(sb,i) ((sb)->lines + (i) * CONSOLE_WIDTH)
+
+/** @brief How many lines each of rings rings of history should hold
+ *
+ *  SCROLLBACK_MAX_LINES, or less if all of them together would take more
+ *  than a SCROLLBACK_MEM_SHARE'th of the memory free now.
+ */
+int scrollback_lines(int rings)
+{
+	unsigned int lines = lmm_avail(&malloc_lmm,0) / SCROLLBACK_MEM_SHARE
+	                     / rings / LINE_BYTES;
+
+	if(lines > SCROLLBACK_MAX_LINES)
+		lines = SCROLLBACK_MAX_LINES;
+	return lines;
+}
+
+/** @brief Sets aside memory for lines lines of history
+ *
+ *  @return 0, or -1 if there is no memory for them, in which case the ring
+ *          keeps nothing
+ */
+int scrollback_init(scrollback_t *sb, int lines)
+{
+	sb->next = sb->count = sb->offset = 0;
+	sb->size = 0;
+	if(lines <= 0 || (sb->lines = smalloc(lines * LINE_BYTES)) == NULL)
+		return -1;
+	sb->size = lines;
+	return 0;
+}
+
+/** @brief Adds a line to history, dropping the oldest if history is full
+ *
+ *  @param line CONSOLE_WIDTH cells
+ */
+void scrollback_push(scrollback_t *sb, const cell_t *line)
+{
+	if(sb->size == 0)
+		return;
+
+	memcpy(RING_LINE(sb,sb->next),line,LINE_BYTES);
+	if(++sb->next == sb->size)
+		sb->next = 0;
+	if(sb->count < sb->size)
+		sb->count++;
+}
+
+/** @brief Clamps a view offset to the history there is */
+int scrollback_clamp(const scrollback_t *sb, int offset)
+{
+	if(offset < 0)
+		return 0;
+	if(offset > sb->count)
+		return sb->count;
+	return offset;
+}
+
+/** @brief The line back lines before the live screen; 1 is the newest
+ *
+ *  back must be between 1 and the number of lines kept.
+ */
+const cell_t *scrollback_line(const scrollback_t *sb, int back)
+{
+	int slot = sb->next - back;
+
+	if(slot < 0)
+		slot += sb->size;
+	return RING_LINE(sb,slot);
+}
@@ -0,0 +1,35 @@
+/** @file scrollback.h
+ *  @brief Lines scrolled off the top of a console, kept for viewing
+ */
+
+#ifndef __SCROLLBACK_H
+#define __SCROLLBACK_H
+
+#include <console_cells.h>
+
+/* Most lines of history a console keeps, however much memory is free */
+#define SCROLLBACK_MAX_LINES 1000
+
+/* All history together takes at most this fraction of the free memory at
+ * boot */
+#define SCROLLBACK_MEM_SHARE 16
+
+typedef struct {
+	cell_t *lines;  /* size lines of CONSOLE_WIDTH cells, or NULL */
+	int size;
+	int next;       /* the slot the next line goes in */
+	int count;      /* lines kept, up to size */
+	int offset;     /* lines of history on screen; 0 is the live screen */
+} scrollback_t;
+
+int scrollback_lines(int rings);
+
+int scrollback_init(scrollback_t *sb, int lines);
+
+void scrollback_push(scrollback_t *sb, const cell_t *line);
+
+int scrollback_clamp(const scrollback_t *sb, int offset);
+
+const cell_t *scrollback_line(const scrollback_t *sb, int back);
+
+#endif
@@ -0,0 +1,173 @@
+/** @file serial.c
+ *
+ *  @brief COM1 serial driver
+ *  Output is queued in a ring and sent by the interrupt handler, which
+ *  fills the UART's 16-byte transmit FIFO each time it empties, so a
+ *  writer never polls the line status register. The transmit interrupt is
+ *  only enabled while there is something to send: enabling it with the
+ *  transmitter idle raises it at once, which starts the first batch.
+ *
+ *  Writers only move tx_tail and the handler only moves tx_head, but both
+ *  write the interrupt enable register according to what's in the ring,
+ *  and the handlers are trap gates, so either can be interrupted between
+ *  looking at the ring and writing the register. The handler could then
+ *  turn the transmit interrupt off just after a writer turned it on for
+ *  bytes the handler didn't see, leaving them queued for good. So each
+ *  does the two with interrupts off, which also keeps a writer called from
+ *  a timer callback from interleaving with one it interrupted. When the
+ *  ring is full, output is dropped and counted in serial_dropped rather
+ *  than waited for, since the writer may have interrupts disabled.
+ *
+ *  Received bytes go into the keyboard's buffer, marked with SERIAL_INPUT,
+ *  for readchar() to return in the order they arrived among keypresses.
+ *  The keyboard handler can interrupt this one, or be interrupted by it,
+ *  in the middle of an insert, so sbuf_insert() runs with interrupts off.
+ *
+ *  @bug No known bugs
+ */
+
+#include <asm.h>
+#include <eflags.h>
+#include <interrupt_defines.h>
+#include <keyhelp.h>
+#include <install_handlers.h>
+#include <serial.h>
+
+#define UART_REG(reg) (COM1_BASE + (reg))
+
+#define TX_MASK (SERIAL_TX_SIZE - 1)
+
+char tx_ring[SERIAL_TX_SIZE];
+volatile unsigned int tx_head = 0;   /* next byte to send */
+volatile unsigned int tx_tail = 0;   /* where the next byte queued goes */
+unsigned int serial_dropped = 0;
+int serial_present = 0;
+
+/** @brief Sets up COM1 at the given rate, 8 data bits, no parity, 1 stop
+ *         bit, with its FIFOs on and receive interrupts enabled
+ *
+ *  The caller installs serial_C_handler() (see install_serial_handler()).
+ *
+ *  @return 0, or -1 if there is no UART at COM1
+ */
+int serial_init(int baud)
+{
+	int divisor = UART_CLOCK / baud;
+
+	/* Anything answering at the port keeps what's written to scratch */
+	outb(UART_REG(UART_SCR),0x5A);
+	if(inb(UART_REG(UART_SCR)) != 0x5A)
+		return -1;
+
+	outb(UART_REG(UART_IER),0);
+	outb(UART_REG(UART_LCR),LCR_DLAB);
+	outb(UART_REG(UART_DLL),divisor & 0xFF);
+	outb(UART_REG(UART_DLM),divisor >> 8);
+	outb(UART_REG(UART_LCR),LCR_8N1);
+	outb(UART_REG(UART_FCR),FCR_ENABLE | FCR_CLEAR | FCR_TRIG_14);
+	outb(UART_REG(UART_MCR),MCR_DTR | MCR_RTS | MCR_OUT2);
+
+	/* Drop anything already received */
+	while(inb(UART_REG(UART_LSR)) & LSR_DR)
+		inb(UART_REG(UART_DATA));
+
+	tx_head = tx_tail = 0;
+	serial_present = 1;
+	outb(UART_REG(UART_IER),IER_RX | IER_LINE);
+	return 0;
+}
+
+/** @brief Queues len bytes of s to send
+ *
+ *  @return how many were queued: fewer than len if the ring filled up
+ */
+int serial_write(const char *s, int len)
+{
+	uint32_t eflags;
+	unsigned int tail;
+	int i;
+
+	if(!serial_present)
+		return 0;
+
+	eflags = get_eflags();
+	disable_interrupts();
+	tail = tx_tail;
+	for(i = 0; i < len && tail - tx_head < SERIAL_TX_SIZE; i++)
+		tx_ring[tail++ & TX_MASK] = s[i];
+	tx_tail = tail;
+	serial_dropped += len - i;
+
+	if(i > 0)
+		outb(UART_REG(UART_IER),IER_RX | IER_LINE | IER_THRE);
+	set_eflags(eflags);
+	return i;
+}
+
+/** @brief How many bytes serial_write() can queue now without dropping any
+ */
+int serial_room()
+{
+	if(!serial_present)
+		return 0;
+	return SERIAL_TX_SIZE - (tx_tail - tx_head);
+}
+
+/** @brief Waits until everything queued has gone to the UART
+ *
+ *  Interrupts must be enabled.
+ */
+void serial_flush()
+{
+	while(serial_present && tx_head != tx_tail)
+		continue;
+}
+
+/* Hands the transmit FIFO, which is empty, as much as it holds */
+void tx_fill_fifo()
+{
+	uint32_t eflags;
+	unsigned int head = tx_head;
+	int n;
+
+	for(n = 0; n < UART_FIFO_SIZE && head != tx_tail; n++)
+		outb(UART_REG(UART_DATA),tx_ring[head++ & TX_MASK]);
+	tx_head = head;
+
+	/* A writer can't queue more between the check and the write */
+	eflags = get_eflags();
+	disable_interrupts();
+	if(head == tx_tail)
+		outb(UART_REG(UART_IER),IER_RX | IER_LINE);
+	set_eflags(eflags);
+}
+
+void serial_C_handler()
+{
+	int iir;
+
+	while(!((iir = inb(UART_REG(UART_IIR))) & IIR_NONE))
+	{
+		switch(iir & IIR_ID)
+		{
+			case IIR_RX:
+			case IIR_TIMEOUT:
+				while(inb(UART_REG(UART_LSR)) & LSR_DR)
+					sbuf_insert(SERIAL_INPUT | inb(UART_REG(UART_DATA)));
+				break;
+
+			case IIR_THRE:
+				tx_fill_fifo();
+				break;
+
+			case IIR_LINE:
+				inb(UART_REG(UART_LSR));
+				break;
+
+			case IIR_MODEM:
+				inb(UART_REG(UART_MSR));
+				break;
+		}
+	}
+	outb(INT_CTL_PORT,INT_ACK_CURRENT);
+}
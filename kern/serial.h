@@ -0,0 +1,73 @@
+/** @file serial.h
+ *  @brief Interrupt-driven driver for the 16550 UART on COM1
+ */
+
+#ifndef __SERIAL_H
+#define __SERIAL_H
+
+#define COM1_BASE 0x3F8
+#define COM1_IRQ 4
+#define COM1_IDT_ENTRY (0x20 + COM1_IRQ)
+
+/* Registers, from the base port */
+#define UART_DATA 0          /* receive buffer / transmit holding */
+#define UART_IER  1          /* interrupt enable */
+#define UART_IIR  2          /* interrupt identification (read) */
+#define UART_FCR  2          /* FIFO control (write) */
+#define UART_LCR  3          /* line control */
+#define UART_MCR  4          /* modem control */
+#define UART_LSR  5          /* line status */
+#define UART_MSR  6          /* modem status */
+#define UART_SCR  7          /* scratch */
+#define UART_DLL  0          /* divisor latch, with LCR_DLAB set */
+#define UART_DLM  1
+
+#define IER_RX    0x01       /* data received */
+#define IER_THRE  0x02       /* transmit holding register empty */
+#define IER_LINE  0x04       /* line status */
+
+#define IIR_NONE     0x01    /* no interrupt pending */
+#define IIR_ID       0x0E
+#define IIR_MODEM    0x00
+#define IIR_THRE     0x02
+#define IIR_RX       0x04
+#define IIR_LINE     0x06
+#define IIR_TIMEOUT  0x0C    /* data waiting in the receive FIFO */
+
+#define FCR_ENABLE   0x01
+#define FCR_CLEAR    0x06    /* empty both FIFOs */
+#define FCR_TRIG_14  0xC0    /* interrupt at 14 bytes received */
+
+#define LCR_8N1   0x03
+#define LCR_DLAB  0x80
+
+#define MCR_DTR   0x01
+#define MCR_RTS   0x02
+#define MCR_OUT2  0x08       /* gates the UART's interrupt onto the IRQ line */
+
+#define LSR_DR    0x01       /* data ready */
+
+/* Bytes the transmit FIFO takes each time it empties */
+#define UART_FIFO_SIZE 16
+
+#define UART_CLOCK 115200
+
+/* Bytes waiting to be sent; a power of two, and room for the largest frame
+ * the recorder sends (FR_MAX_FRAME, about 6 KB) */
+#define SERIAL_TX_SIZE 8192
+
+/* Marks a byte from the serial line in the keyboard's buffer, to tell it
+ * from a scancode */
+#define SERIAL_INPUT 0x100
+
+int serial_init(int baud);
+
+int serial_write(const char *s, int len);
+
+int serial_room();
+
+void serial_flush();
+
+void serial_C_handler();
+
+#endif
@@ -0,0 +1,85 @@
+/** @file sprite.c
+ *
+ *  @brief Sprites for text-mode games
+ *
+ *  A sprite is drawn with its top left cell at column x, row y, clipped to
+ *  the screen. A sprite with a save buffer can be erased by copying back
+ *  the cells it covered, so moving it costs two copies the size of the
+ *  sprite rather than a redraw of the board beneath it. Sprites that
+ *  overlap must be erased in the reverse of the order they were drawn.
+ *
+ *  Sprites are drawn into the console's shadow of the screen and copied
+ *  from there to the page output goes to (see console_begin_frame()), so
+ *  saving the background never reads text memory.
+ *
+ *  @bug No known bugs
+ */
+
+#include <stddef.h>
+#include <video_defines.h>
+#include <console_device_driver.h>
+#include <sprite.h>
+
+/** @brief Sets up a sprite from its cells
+ *
+ *  @param saved NULL, or room for width * height cells to save the
+ *         background in
+ */
+void sprite_init(sprite_t *sprite, int width, int height, const cell_t *cells,
+                 cell_t key, cell_t *saved)
+{
+	sprite->width = width;
+	sprite->height = height;
+	sprite->cells = cells;
+	sprite->key = key;
+	sprite->saved = saved;
+	sprite->saved_h = 0;
+}
+
+/** @brief Draws a sprite at column x, row y, saving what it covers first if
+ *         it has a save buffer */
+void sprite_draw(int x, int y, sprite_t *sprite)
+{
+	int row = y, col = x;
+	int h = sprite->height, w = sprite->width;
+	int skip = clip_rect(&row,&col,&h,&w,sprite->width);
+
+	sprite->saved_h = 0;
+	if(skip < 0)
+		return;
+
+	if(sprite->saved != NULL)
+	{
+		cells_copy(sprite->saved,w,console_shadow_ptr(row,col),CONSOLE_WIDTH,
+		           h,w);
+		sprite->saved_row = row;
+		sprite->saved_col = col;
+		sprite->saved_h = h;
+		sprite->saved_w = w;
+	}
+
+	cells_copy_keyed(console_shadow_ptr(row,col),CONSOLE_WIDTH,
+	                 sprite->cells + skip,sprite->width,h,w,sprite->key);
+	console_sync_rect(row,col,h,w);
+}
+
+/** @brief Puts back what the sprite covered when last drawn */
+void sprite_erase(sprite_t *sprite)
+{
+	if(sprite->saved == NULL || sprite->saved_h == 0)
+		return;
+
+	cells_copy(console_shadow_ptr(sprite->saved_row,sprite->saved_col),
+	           CONSOLE_WIDTH,sprite->saved,sprite->saved_w,
+	           sprite->saved_h,sprite->saved_w);
+	console_sync_rect(sprite->saved_row,sprite->saved_col,
+	                  sprite->saved_h,sprite->saved_w);
+	sprite->saved_h = 0;
+}
+
+/** @brief Erases a sprite and draws it again at column x, row y */
+void sprite_move(int x, int y, sprite_t *sprite)
+{
+	sprite_erase(sprite);
+	sprite_draw(x,y,sprite);
+}
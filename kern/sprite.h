@@ -0,0 +1,32 @@
+/** @file sprite.h
+ *  @brief Sprites: blocks of cells drawn over the console with transparency
+ */
+
+#ifndef __SPRITE_H
+#define __SPRITE_H
+
+#include <console_cells.h>
+
+typedef struct {
+	int width;
+	int height;
+	const cell_t *cells;   /* height rows of width cells */
+	cell_t key;            /* cells equal to this are transparent */
+
+	/* If non-NULL, room for width * height cells in which sprite_draw()
+	 * keeps what it covered, so sprite_erase() can put it back */
+	cell_t *saved;
+	int saved_row, saved_col;
+	int saved_h, saved_w;  /* saved_h is 0 if nothing is saved */
+} sprite_t;
+
+void sprite_init(sprite_t *sprite, int width, int height, const cell_t *cells,
+                 cell_t key, cell_t *saved);
+
+void sprite_draw(int x, int y, sprite_t *sprite);
+
+void sprite_erase(sprite_t *sprite);
+
+void sprite_move(int x, int y, sprite_t *sprite);
+
+#endif
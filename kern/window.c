@@ -0,0 +1,177 @@
+/** @file window.c
+ *
+ *  @brief Console windows
+ *  A window is a rectangle of the screen with its own cursor, color, and
+ *  wrapping and scrolling, so a message log can scroll under a HUD without
+ *  the HUD being redrawn. Scrolling moves only the window's own cells, a
+ *  row at a time, or all at once if the window is the full width of the
+ *  screen.
+ *
+ *  Text is written into the console's shadow (see console_shadow_ptr()),
+ *  and the rows it touched go to text memory once per call, so a burst of
+ *  output that scrolls many times still copies each row out only once.
+ *  The hardware cursor is left alone.
+ *
+ *  @bug No known bugs
+ */
+
+#include <string.h>
+#include <video_defines.h>
+#include <console_device_driver.h>
+#include <window.h>
+
+#define WIN_PTR(win,row,col) \
+	console_shadow_ptr((win)->top + (row),(win)->left + (col))
+
+#define BLANK(win) MAKE_CELL(0,(win)->color)
+
+/** @brief Sets up a window, clipped to the screen, with the cursor at its
+ *         top left
+ *
+ *  @return 0, or -1 if none of the window is on the screen
+ */
+int window_init(window_t *win, int top, int left, int height, int width,
+                int color, int flags)
+{
+	if(clip_rect(&top,&left,&height,&width,0) < 0)
+		return -1;
+
+	win->top = top;
+	win->left = left;
+	win->height = height;
+	win->width = width;
+	win->row = win->col = 0;
+	win->color = color;
+	win->flags = flags;
+	return 0;
+}
+
+/* Moves the window's rows up by lines, or down if lines is negative, and
+ * blanks the rows uncovered, in the shadow only */
+void shift_rows(window_t *win, int lines)
+{
+	int n = lines < 0 ? -lines : lines;
+	int keep, r;
+
+	if(n > win->height)
+		n = win->height;
+	keep = win->height - n;
+
+	if(win->width == CONSOLE_WIDTH)
+	{
+		/* The rows are next to each other: one move does */
+		if(lines > 0)
+			memmove(WIN_PTR(win,0,0),WIN_PTR(win,n,0),
+			        keep * CONSOLE_WIDTH * sizeof(cell_t));
+		else
+			memmove(WIN_PTR(win,n,0),WIN_PTR(win,0,0),
+			        keep * CONSOLE_WIDTH * sizeof(cell_t));
+	}
+	else if(lines > 0)
+	{
+		for(r = 0; r < keep; r++)
+			memmove(WIN_PTR(win,r,0),WIN_PTR(win,r + n,0),
+			        win->width * sizeof(cell_t));
+	}
+	else
+	{
+		for(r = win->height - 1; r >= n; r--)
+			memmove(WIN_PTR(win,r,0),WIN_PTR(win,r - n,0),
+			        win->width * sizeof(cell_t));
+	}
+
+	cells_fill(WIN_PTR(win,lines > 0 ? keep : 0,0),CONSOLE_WIDTH,n,win->width,
+	           BLANK(win));
+}
+
+/* Moves the cursor to the start of the next row, scrolling or going back to
+ * the top at the bottom. Returns whether the window scrolled. */
+int window_newline(window_t *win)
+{
+	win->col = 0;
+	if(++win->row < win->height)
+		return 0;
+
+	if(win->flags & WINDOW_SCROLL)
+	{
+		win->row = win->height - 1;
+		shift_rows(win,1);
+		return 1;
+	}
+	win->row = 0;
+	return 0;
+}
+
+/** @brief Writes len bytes of s into the window at its cursor, in its color
+ *
+ *  '\n', '\r' and '\b' move the cursor as putbytes() does on the screen.
+ */
+void window_putbytes(window_t *win, const char *s, int len)
+{
+	int first = win->row, last = win->row;
+	int scrolled = 0;
+	int i;
+
+	for(i = 0; i < len; i++)
+	{
+		switch(s[i])
+		{
+			case '\n':
+				scrolled |= window_newline(win);
+				break;
+
+			case '\r':
+				win->col = 0;
+				break;
+
+			case '\b':
+				if(win->col > 0)
+				{
+					win->col--;
+					*WIN_PTR(win,win->row,win->col) = BLANK(win);
+				}
+				break;
+
+			default:
+				if(win->col == win->width)
+				{
+					if(!(win->flags & WINDOW_WRAP))
+						break;
+					scrolled |= window_newline(win);
+				}
+				*WIN_PTR(win,win->row,win->col++) = MAKE_CELL(s[i],win->color);
+		}
+
+		if(win->row < first)
+			first = win->row;
+		if(win->row > last)
+			last = win->row;
+	}
+
+	/* After a scroll every row has moved */
+	if(scrolled)
+	{
+		first = 0;
+		last = win->height - 1;
+	}
+	console_sync_rect(win->top + first,win->left,last - first + 1,win->width);
+}
+
+/** @brief Scrolls the window's contents up by lines, or down if lines is
+ *         negative; the cursor stays put */
+void window_scroll(window_t *win, int lines)
+{
+	if(lines == 0)
+		return;
+	shift_rows(win,lines);
+	console_sync_rect(win->top,win->left,win->height,win->width);
+}
+
+/** @brief Blanks the window and puts its cursor at the top left */
+void window_clear(window_t *win)
+{
+	cells_fill(WIN_PTR(win,0,0),CONSOLE_WIDTH,win->height,win->width,
+	           BLANK(win));
+	win->row = win->col = 0;
+	console_sync_rect(win->top,win->left,win->height,win->width);
+}
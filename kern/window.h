@@ -0,0 +1,35 @@
+/** @file window.h
+ *  @brief Rectangles of the console that text is written into and
+ *         scrolled within on their own
+ */
+
+#ifndef __WINDOW_H
+#define __WINDOW_H
+
+#include <console_cells.h>
+
+/* Text reaching the right edge carries on at the start of the next row;
+ * otherwise it is dropped until the next newline */
+#define WINDOW_WRAP   0x1
+/* A newline on the bottom row scrolls the window up; otherwise the cursor
+ * goes back to the top row */
+#define WINDOW_SCROLL 0x2
+
+typedef struct {
+	int top, left;       /* where the window is on the screen */
+	int height, width;
+	int row, col;        /* the cursor, from the window's top left */
+	int color;
+	int flags;           /* WINDOW_WRAP and WINDOW_SCROLL */
+} window_t;
+
+int window_init(window_t *win, int top, int left, int height, int width,
+                int color, int flags);
+
+void window_putbytes(window_t *win, const char *s, int len);
+
+void window_scroll(window_t *win, int lines);
+
+void window_clear(window_t *win);
+
+#endif